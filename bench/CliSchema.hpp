@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ArgumentParser::Bench {
+
+// The schema of a generated CLI. It's shared by the generator and the benchmark,
+// so the benchmark knows which argv the CLI accepts.
+enum class OptionKind {
+    kFlag,
+    kInt,
+    kString,
+    kDouble
+};
+
+// The number of options set in the argv of a single run
+inline constexpr size_t kOptionsInArgv = 16;
+
+inline OptionKind GetOptionKind(size_t index) {
+    return static_cast<OptionKind>(index % 4);
+}
+
+inline std::string GetOptionName(size_t index) {
+    return "option-" + std::to_string(index);
+}
+
+// Options spread evenly over the schema in the forms users actually write
+inline std::vector<std::string> BuildArgv(const std::string& program, size_t options_count) {
+    std::vector<std::string> argv = {program};
+    size_t step = (options_count > kOptionsInArgv) ? options_count / kOptionsInArgv : 1;
+
+    for (size_t index = 0; index < options_count && argv.size() <= 2 * kOptionsInArgv; index += step) {
+        std::string option = "--" + GetOptionName(index);
+
+        switch (GetOptionKind(index)) {
+            case OptionKind::kFlag:
+                argv.push_back(option);
+                break;
+            case OptionKind::kInt:
+                argv.push_back(option + "=" + std::to_string(index));
+                break;
+            case OptionKind::kString:
+                argv.push_back(option);
+                argv.push_back("some/path/to/file-" + std::to_string(index) + ".txt");
+                break;
+            case OptionKind::kDouble:
+                argv.push_back(option + "=2.5");
+                break;
+        }
+    }
+
+    return argv;
+}
+
+} // namespace ArgumentParser::Bench
@@ -0,0 +1,113 @@
+#include "CliSchema.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Options are registered by functions of this size, a single huge function takes the compiler too long
+constexpr size_t kOptionsPerFunction = 50;
+
+using namespace ArgumentParser::Bench;
+
+/*
+    Writes the source of a CLI like bin/main.cpp with the given number of options.
+    The CLI prints three steady_clock timestamps in nanoseconds:
+    the start of the static initialization, the start of main and the end of the argument handling.
+*/
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <options count> <output file>" << std::endl;
+        return 1;
+    }
+
+    size_t options_count = std::strtoull(argv[1], nullptr, 10);
+    std::ofstream output(argv[2]);
+
+    if (!output) {
+        std::cerr << "Cannot open " << argv[2] << std::endl;
+        return 1;
+    }
+
+    output << "#include \"lib/ArgParser.hpp\"\n"
+              "\n"
+              "#include <chrono>\n"
+              "#include <cstdio>\n"
+              "\n"
+              "namespace {\n"
+              "\n"
+              "long long Now() {\n"
+              "    return std::chrono::duration_cast<std::chrono::nanoseconds>(\n"
+              "        std::chrono::steady_clock::now().time_since_epoch()).count();\n"
+              "}\n"
+              "\n"
+              "// Constructed before any other static object of the executable\n"
+              "struct StaticInitializationClock {\n"
+              "    long long start = Now();\n"
+              "};\n"
+              "\n"
+              "StaticInitializationClock static_initialization_clock __attribute__((init_priority(101)));\n"
+              "\n";
+
+    size_t functions_count = (options_count + kOptionsPerFunction - 1) / kOptionsPerFunction;
+
+    for (size_t index = 0; index < options_count; ++index) {
+        if (index % kOptionsPerFunction == 0) {
+            output << "void AddOptions" << index / kOptionsPerFunction << "(ArgumentParser::ArgParser& parser) {\n";
+        }
+
+        std::string name = GetOptionName(index);
+        output << "    parser.";
+
+        switch (GetOptionKind(index)) {
+            case OptionKind::kFlag:
+                output << "AddFlag(\"" << name << "\", \"Flag " << index << "\");\n";
+                break;
+            case OptionKind::kInt:
+                output << "AddIntArgument(\"" << name << "\", \"Number " << index << "\").Default(" << index << ");\n";
+                break;
+            case OptionKind::kString:
+                output << "AddStringArgument(\"" << name << "\", \"Path " << index << "\").Default(\"input.txt\");\n";
+                break;
+            case OptionKind::kDouble:
+                output << "AddDoubleArgument(\"" << name << "\", \"Ratio " << index << "\").Default(0.5);\n";
+                break;
+        }
+
+        if (index % kOptionsPerFunction == kOptionsPerFunction - 1 || index == options_count - 1) {
+            output << "}\n"
+                      "\n";
+        }
+    }
+
+    output << "} // namespace\n"
+              "\n"
+              "int main(int argc, char** argv) {\n"
+              "    long long main_start = Now();\n"
+              "\n"
+              "    ArgumentParser::ArgParser parser(\"cli\", \"Generated CLI with " << options_count << " options\");\n";
+
+    for (size_t function = 0; function < functions_count; ++function) {
+        output << "    AddOptions" << function << "(parser);\n";
+    }
+
+    output << "    parser.AddHelp('h', \"help\", \"Show help and exit\");\n"
+              "\n"
+              "    if (!parser.Parse(argc, argv)) {\n"
+              "        std::fputs(parser.HelpDescription().c_str(), stderr);\n"
+              "        return 1;\n"
+              "    }\n"
+              "\n"
+              "    if (parser.Help()) {\n"
+              "        std::puts(parser.HelpDescription().c_str());\n"
+              "        return 0;\n"
+              "    }\n"
+              "\n"
+              "    long long parsed = Now();\n"
+              "    std::printf(\"%lld %lld %lld\\n\", static_initialization_clock.start, main_start, parsed);\n"
+              "\n"
+              "    return 0;\n"
+              "}\n";
+
+    return output ? 0 : 1;
+}
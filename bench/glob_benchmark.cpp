@@ -0,0 +1,60 @@
+#include "lib/GlobExpander.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+using namespace ArgumentParser;
+
+/*
+    Measures the expansion of "**" patterns over a generated tree of 1000 directories
+    with 50 files each, by one thread and by the pool of threads
+*/
+namespace {
+
+class Tree {
+public:
+    Tree()
+        : root_(std::filesystem::temp_directory_path()
+                / ("argparser_glob_benchmark_" + std::to_string(std::random_device{}()))) {
+        for (size_t i = 0; i < 10; ++i) {
+            for (size_t j = 0; j < 100; ++j) {
+                std::filesystem::path directory = root_ / ("year" + std::to_string(i)) / ("part" + std::to_string(j));
+                std::filesystem::create_directories(directory);
+
+                for (size_t k = 0; k < 50; ++k) {
+                    std::ofstream(directory / ("file" + std::to_string(k) + (k % 5 == 0 ? ".parquet" : ".crc")));
+                }
+            }
+        }
+    }
+
+    ~Tree() {
+        std::filesystem::remove_all(root_);
+    }
+
+    std::string GetPattern() const {
+        return root_.string() + "/**/*.parquet";
+    }
+
+private:
+    std::filesystem::path root_;
+};
+
+void BM_GlobExpand(benchmark::State& state) {
+    static Tree tree;
+    GlobExpander expander(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(expander.Expand(tree.GetPattern()).size());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_GlobExpand)->Arg(1)->Arg(4)->Arg(16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
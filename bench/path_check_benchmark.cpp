@@ -0,0 +1,106 @@
+#include "lib/PathCheck.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace ArgumentParser;
+
+/*
+    Measures the checks of a list of input files, like a MultiValue().Positional() path argument gets:
+    stat() of every path in turn against one batch through io_uring or the thread pool.
+    On a local file system the paths are in the cache, the difference grows with the latency of the file system
+*/
+namespace {
+
+class InputFiles {
+public:
+    explicit InputFiles(size_t count)
+        : directory_(std::filesystem::temp_directory_path()
+                     / ("argparser_path_benchmark_" + std::to_string(std::random_device{}()))) {
+        std::filesystem::create_directories(directory_);
+
+        for (size_t i = 0; i < count; ++i) {
+            paths_.push_back(directory_ / ("input" + std::to_string(i)));
+            std::ofstream(paths_.back()) << i;
+        }
+    }
+
+    ~InputFiles() {
+        std::filesystem::remove_all(directory_);
+    }
+
+    const std::vector<std::filesystem::path>& GetPaths() const {
+        return paths_;
+    }
+
+private:
+    std::filesystem::path directory_;
+    std::vector<std::filesystem::path> paths_;
+};
+
+void BM_SerialStat(benchmark::State& state) {
+    InputFiles files(state.range(0));
+
+    for (auto _ : state) {
+        for (const std::filesystem::path& path : files.GetPaths()) {
+            struct stat status;
+            benchmark::DoNotOptimize(stat(path.c_str(), &status));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ThreadPool(benchmark::State& state) {
+    InputFiles files(state.range(0));
+    PathCheckBatch batch;
+
+    for (auto _ : state) {
+        batch.Clear();
+
+        for (const std::filesystem::path& path : files.GetPaths()) {
+            batch.Add(path);
+        }
+
+        batch.RunThreadPool();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_IoUring(benchmark::State& state) {
+    if (!PathCheckBatch::IsIoUringAvailable()) {
+        state.SkipWithError("io_uring is unavailable");
+        return;
+    }
+
+    InputFiles files(state.range(0));
+    PathCheckBatch batch;
+
+    for (auto _ : state) {
+        batch.Clear();
+
+        for (const std::filesystem::path& path : files.GetPaths()) {
+            batch.Add(path);
+        }
+
+        batch.RunIoUring();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_SerialStat)->Arg(100)->Arg(5000)->UseRealTime();
+BENCHMARK(BM_ThreadPool)->Arg(100)->Arg(5000)->UseRealTime();
+BENCHMARK(BM_IoUring)->Arg(100)->Arg(5000)->UseRealTime();
+
+BENCHMARK_MAIN();
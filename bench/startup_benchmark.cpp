@@ -0,0 +1,241 @@
+#include "CliSchema.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#define ARGPARSER_BENCH_HAS_PERF
+#endif
+
+using namespace ArgumentParser::Bench;
+
+/*
+    Executes generated CLIs with a realistic argv and reports the cost of the process startup:
+    the time from exec to the end of the argument handling, the time of the static initialization,
+    the wall time of the whole run, the number of user-space instructions and page faults,
+    and the size of the binary.
+
+    Usage: argparser_startup_benchmark <runs> <options count> <cli> [<options count> <cli> ...]
+*/
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RunResult {
+    int64_t exec_to_parsed_ns = 0;
+    int64_t static_initialization_ns = 0;
+    int64_t wall_ns = 0;
+    std::optional<uint64_t> instructions;
+    std::optional<uint64_t> page_faults;
+};
+
+int64_t ToNanoseconds(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// The counter starts on the exec of the child, so the fork and the benchmark itself are not counted.
+// Returns -1 when perf_event_open is not available (no kernel support, a container, perf_event_paranoid)
+int OpenCounter(pid_t pid, uint32_t type, uint64_t config) {
+#ifdef ARGPARSER_BENCH_HAS_PERF
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.enable_on_exec = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, pid, -1, -1, 0));
+#else
+    return -1;
+#endif
+}
+
+std::optional<uint64_t> ReadCounter(int counter) {
+    if (counter < 0) {
+        return std::nullopt;
+    }
+
+    uint64_t value = 0;
+    bool is_read = read(counter, &value, sizeof(value)) == sizeof(value);
+    close(counter);
+
+    if (!is_read) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+std::optional<RunResult> Run(const std::vector<std::string>& argv) {
+    std::vector<char*> exec_argv;
+
+    for (const std::string& argument : argv) {
+        exec_argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+
+    exec_argv.push_back(nullptr);
+
+    int start_pipe[2];
+    int output_pipe[2];
+
+    if (pipe(start_pipe) != 0 || pipe(output_pipe) != 0) {
+        return std::nullopt;
+    }
+
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        return std::nullopt;
+    }
+
+    if (pid == 0) {
+        // Wait until the counters are attached
+        char start;
+        close(start_pipe[1]);
+        close(output_pipe[0]);
+
+        if (read(start_pipe[0], &start, 1) != 1) {
+            _exit(127);
+        }
+
+        dup2(output_pipe[1], STDOUT_FILENO);
+        execv(exec_argv[0], exec_argv.data());
+        _exit(127);
+    }
+
+    close(start_pipe[0]);
+    close(output_pipe[1]);
+
+    int instructions_counter = -1;
+    int page_faults_counter = -1;
+
+#ifdef ARGPARSER_BENCH_HAS_PERF
+    instructions_counter = OpenCounter(pid, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    page_faults_counter = OpenCounter(pid, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+
+    Clock::time_point start = Clock::now();
+    bool is_started = write(start_pipe[1], "s", 1) == 1;
+    close(start_pipe[1]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    Clock::time_point end = Clock::now();
+
+    RunResult result;
+    result.instructions = ReadCounter(instructions_counter);
+    result.page_faults = ReadCounter(page_faults_counter);
+
+    char output[256] = {};
+    ssize_t output_length = read(output_pipe[0], output, sizeof(output) - 1);
+    close(output_pipe[0]);
+
+    long long static_initialization_start = 0;
+    long long main_start = 0;
+    long long parsed = 0;
+
+    if (!is_started || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || output_length <= 0 ||
+        std::sscanf(output, "%lld %lld %lld", &static_initialization_start, &main_start, &parsed) != 3) {
+        return std::nullopt;
+    }
+
+    result.exec_to_parsed_ns = parsed - ToNanoseconds(start);
+    result.static_initialization_ns = main_start - static_initialization_start;
+    result.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    return result;
+}
+
+template<typename T>
+T Median(std::vector<T> values) {
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+std::string FormatCounter(const std::vector<RunResult>& results, std::optional<uint64_t> RunResult::* counter) {
+    std::vector<uint64_t> values;
+
+    for (const RunResult& result : results) {
+        if (!(result.*counter).has_value()) {
+            return "n/a";
+        }
+
+        values.push_back(*(result.*counter));
+    }
+
+    return std::to_string(Median(values));
+}
+
+double MedianMicroseconds(const std::vector<RunResult>& results, int64_t RunResult::* time) {
+    std::vector<int64_t> values;
+
+    for (const RunResult& result : results) {
+        values.push_back(result.*time);
+    }
+
+    return static_cast<double>(Median(values)) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4 || argc % 2 != 0) {
+        std::fprintf(stderr, "Usage: %s <runs> <options count> <cli> [<options count> <cli> ...]\n", argv[0]);
+        return 1;
+    }
+
+    size_t runs = std::max<size_t>(1, std::strtoull(argv[1], nullptr, 10));
+
+    std::printf("%10s %16s %16s %12s %14s %12s %12s\n",
+                "options", "exec-parsed, us", "static init, us", "wall, us", "instructions", "page faults", "size, bytes");
+
+    for (int i = 2; i < argc; i += 2) {
+        size_t options_count = std::strtoull(argv[i], nullptr, 10);
+        std::string cli = std::filesystem::absolute(argv[i + 1]).string();
+        std::vector<std::string> cli_argv = BuildArgv(cli, options_count);
+
+        // The first run warms up the page cache and is not counted
+        std::vector<RunResult> results;
+
+        for (size_t run = 0; run <= runs; ++run) {
+            std::optional<RunResult> result = Run(cli_argv);
+
+            if (!result.has_value()) {
+                std::fprintf(stderr, "The run of %s has failed\n", cli.c_str());
+                return 1;
+            }
+
+            if (run != 0) {
+                results.push_back(*result);
+            }
+        }
+
+        std::printf("%10zu %16.1f %16.1f %12.1f %14s %12s %12ju\n",
+                    options_count,
+                    MedianMicroseconds(results, &RunResult::exec_to_parsed_ns),
+                    MedianMicroseconds(results, &RunResult::static_initialization_ns),
+                    MedianMicroseconds(results, &RunResult::wall_ns),
+                    FormatCounter(results, &RunResult::instructions).c_str(),
+                    FormatCounter(results, &RunResult::page_faults).c_str(),
+                    static_cast<uintmax_t>(std::filesystem::file_size(cli)));
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "lib/Utf8.hpp"
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+using namespace ArgumentParser;
+
+/*
+    Measures the throughput of the UTF-8 validators over text like paths and labels:
+    mostly ASCII with some two, three and four byte sequences
+*/
+namespace {
+
+std::string BuildText(size_t size) {
+    const std::string pieces[] = {"/usr/share/data/", "caf\xc3\xa9", "\xd0\xbc\xd0\xb8\xd1\x80", "-",
+                                  "\xe2\x82\xac", "label_", "\xf0\x9f\x98\x80", ".txt"};
+    std::string text;
+
+    for (size_t i = 0; text.size() < size; ++i) {
+        text += pieces[(i * 7) % std::size(pieces)];
+    }
+
+    return text;
+}
+
+template<bool (*Validate)(std::string_view)>
+void BM_ValidateUtf8(benchmark::State& state) {
+    std::string text = BuildText(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Validate(text));
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_ValidateUtf8, &IsValidUtf8Scalar)->Arg(64)->Arg(64 << 10);
+BENCHMARK_TEMPLATE(BM_ValidateUtf8, &IsValidUtf8)->Arg(64)->Arg(64 << 10);
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+BENCHMARK_TEMPLATE(BM_ValidateUtf8, &IsValidUtf8Sse4)->Arg(64)->Arg(64 << 10);
+BENCHMARK_TEMPLATE(BM_ValidateUtf8, &IsValidUtf8Avx2)->Arg(64)->Arg(64 << 10);
+#endif
+
+BENCHMARK_MAIN();
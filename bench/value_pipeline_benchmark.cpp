@@ -0,0 +1,112 @@
+#include "lib/ArgParser.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+using namespace ArgumentParser;
+
+/*
+    Measures the path of a value from the converter to the storage
+    for std::string values and for a large user type which counts its copies
+*/
+namespace {
+
+constexpr size_t kValuesCount = 256;
+
+struct LargeValue {
+    static inline size_t copies = 0;
+
+    std::array<char, 1024> payload{};
+    std::vector<int> parts;
+
+    LargeValue() = default;
+    LargeValue(const LargeValue& other) : payload(other.payload), parts(other.parts) {
+        ++copies;
+    }
+    LargeValue(LargeValue&& other) noexcept = default;
+    LargeValue& operator=(const LargeValue& other) {
+        payload = other.payload;
+        parts = other.parts;
+        ++copies;
+        return *this;
+    }
+    LargeValue& operator=(LargeValue&& other) noexcept = default;
+};
+
+std::vector<std::string> BuildArgv(std::string_view name) {
+    std::vector<std::string> argv = {"app"};
+
+    for (size_t i = 0; i < kValuesCount; ++i) {
+        argv.push_back("--" + std::string(name) + "=/some/long/path/which/does/not/fit/into/the/string/" + std::to_string(i));
+    }
+
+    return argv;
+}
+
+} // namespace
+
+template<>
+inline std::optional<LargeValue> ArgumentParser::ParseValue<LargeValue>(std::string_view value_string) {
+    LargeValue result;
+    std::copy_n(value_string.begin(), std::min(value_string.size(), result.payload.size()), result.payload.begin());
+    result.parts.assign(value_string.size(), 0);
+
+    return result;
+}
+
+template<typename T>
+void BM_MultiValue(benchmark::State& state) {
+    ArgParser parser("Benchmark");
+    parser.AddArgument<T>("value").MultiValue();
+    std::vector<std::string> argv = BuildArgv("value");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(argv));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kValuesCount);
+}
+
+template<typename T>
+void BM_StoreValue(benchmark::State& state) {
+    ArgParser parser("Benchmark");
+    T stored{};
+    parser.AddArgument<T>("value").StoreValue(stored);
+    std::vector<std::string> argv = BuildArgv("value");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(argv));
+    }
+
+    state.SetItemsProcessed(state.iterations() * kValuesCount);
+}
+
+void BM_LargeValueCopies(benchmark::State& state) {
+    ArgParser parser("Benchmark");
+    LargeValue stored;
+    parser.AddArgument<LargeValue>("multi").MultiValue();
+    parser.AddArgument<LargeValue>("stored").StoreValue(stored);
+
+    std::vector<std::string> argv = BuildArgv("multi");
+    argv.push_back("--stored=value");
+
+    LargeValue::copies = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.Parse(argv));
+    }
+
+    state.counters["copies per parse"] = benchmark::Counter(
+        static_cast<double>(LargeValue::copies) / static_cast<double>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(BM_MultiValue, std::string);
+BENCHMARK_TEMPLATE(BM_MultiValue, LargeValue);
+BENCHMARK_TEMPLATE(BM_StoreValue, std::string);
+BENCHMARK_TEMPLATE(BM_StoreValue, LargeValue);
+BENCHMARK(BM_LargeValueCopies);
+
+BENCHMARK_MAIN();
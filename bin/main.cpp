@@ -7,6 +7,7 @@
 struct Options {
     bool sum = false;
     bool mult = false;
+    std::string name = "John Doe";
 };
 
 int main(int argc, char** argv) {
@@ -15,9 +16,12 @@ int main(int argc, char** argv) {
 
     ArgumentParser::ArgParser parser("Program", "Program accumulate arguments");
     parser.AddArgument<int>("numbers").MultiValue(1).Positional().StoreValues(values);
-    parser.AddFlag('s', "sum", "Sum arguments").StoreValue(opt.sum);
-    parser.AddFlag('m', "mult", "Multiply arguments").StoreValue(opt.mult);
-    parser.AddArgument<std::string>('n', "name", "Your name").Default("John Doe");
+
+    auto binder = parser.BindStruct(opt);
+    binder.Bind(&Options::sum, "sum", 's', "Sum arguments");
+    binder.Bind(&Options::mult, "mult", 'm', "Multiply arguments");
+    binder.Bind(&Options::name, "name", 'n', "Your name");
+
     parser.AddHelp('h', "help", "Show help and exit");
 
     if (!parser.Parse(argc, argv)) {
@@ -37,7 +41,7 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::cout << "Hello " << *parser.GetValue<std::string>("name") << '!' << std::endl;
+    std::cout << "Hello " << opt.name << '!' << std::endl;
 
     if (opt.sum) {
         std::cout << "Sum: " << std::accumulate(values.begin(), values.end(), 0) << std::endl;
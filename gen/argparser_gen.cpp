@@ -0,0 +1,693 @@
+#include "lib/ArgParser.hpp"
+#include "lib/GeneratedParser.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+    Compiles a schema of a command line into the source of a parser, in the spirit of gperf.
+    The schema has one declaration per line, '#' starts a comment:
+
+        program copy description="Copies files"
+        namespace Copy
+        argument level int short=l default=3 description="Compression level"
+        argument files string positional multi=1 description="Files to copy"
+        help help short=h description="Show help and exit"
+
+    The generated header defines <namespace>::Options with a typed field for every argument
+    and <namespace>::Parser, an ArgumentParser::GeneratedParser over the compiled tables.
+*/
+
+namespace {
+
+using namespace ArgumentParser;
+
+// The argument names are found with the "hash, displace" scheme: a name is hashed into a bucket,
+// and every bucket has its own seed which places all its names into free slots
+constexpr size_t kNamesPerBucket = 4;
+constexpr uint32_t kMaxSeed = 1 << 20;
+
+struct ArgumentSchema {
+    std::string long_name;
+    std::string field_name;
+    char short_name = kNoShortName;
+    std::string type;
+    std::optional<std::string> default_value;
+    bool is_positional = false;
+    bool is_multi_value = false;
+    size_t minimum_values = 0;
+    bool is_help = false;
+    std::string description;
+    size_t line = 0;
+};
+
+struct Schema {
+    std::string program_name = "program";
+    std::string program_description;
+    std::string namespace_name = "Generated";
+    std::vector<ArgumentSchema> arguments;
+};
+
+struct PerfectHash {
+    std::vector<uint32_t> seeds;
+    std::vector<int32_t> slots;
+};
+
+class SchemaError {
+public:
+    SchemaError(size_t line, std::string message) : line_(line), message_(std::move(message)) {}
+
+    size_t GetLine() const {
+        return line_;
+    }
+
+    const std::string& GetMessage() const {
+        return message_;
+    }
+
+private:
+    size_t line_;
+    std::string message_;
+};
+
+// Splits a line by spaces. Double quotes group the spaces into a token, '\' escapes the next symbol
+std::vector<std::string> SplitLine(std::string_view line, size_t line_number) {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool is_in_token = false;
+    bool is_quoted = false;
+
+    for (size_t i = 0; i < line.size(); ++i) {
+        char symbol = line[i];
+
+        if (!is_quoted && symbol == '#') {
+            break;
+        }
+
+        if (!is_quoted && (symbol == ' ' || symbol == '\t' || symbol == '\r')) {
+            if (is_in_token) {
+                tokens.push_back(std::move(token));
+                token.clear();
+                is_in_token = false;
+            }
+
+            continue;
+        }
+
+        is_in_token = true;
+
+        if (symbol == '"') {
+            is_quoted = !is_quoted;
+        } else if (symbol == '\\' && i + 1 < line.size()) {
+            token += line[++i];
+        } else {
+            token += symbol;
+        }
+    }
+
+    if (is_quoted) {
+        throw SchemaError(line_number, "unterminated quote");
+    }
+
+    if (is_in_token) {
+        tokens.push_back(std::move(token));
+    }
+
+    return tokens;
+}
+
+std::string GetFieldName(std::string_view long_name) {
+    static const std::set<std::string, std::less<>> kKeywords = {
+        "auto", "bool", "break", "case", "char", "class", "const", "continue", "default", "delete", "do",
+        "double", "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+        "if", "inline", "int", "long", "namespace", "new", "operator", "private", "protected", "public",
+        "register", "return", "short", "signed", "sizeof", "static", "struct", "switch", "template", "this",
+        "throw", "true", "try", "typedef", "typename", "union", "unsigned", "using", "virtual", "void",
+        "volatile", "while"};
+
+    std::string field_name;
+
+    for (char symbol : long_name) {
+        bool is_identifier_symbol = std::isalnum(static_cast<unsigned char>(symbol)) || symbol == '_';
+        field_name += is_identifier_symbol ? symbol : '_';
+    }
+
+    if (field_name.empty() || std::isdigit(static_cast<unsigned char>(field_name[0])) || kKeywords.contains(field_name)) {
+        field_name += '_';
+    }
+
+    return field_name;
+}
+
+ArgumentSchema ParseArgument(const std::vector<std::string>& tokens, size_t line_number, bool is_help) {
+    size_t first_option = is_help ? 2 : 3;
+
+    if (tokens.size() < first_option) {
+        throw SchemaError(line_number, is_help ? "expected: help <long name> [options]"
+                                               : "expected: argument <long name> <type> [options]");
+    }
+
+    ArgumentSchema argument;
+    argument.long_name = tokens[1];
+    argument.field_name = GetFieldName(argument.long_name);
+    argument.type = is_help ? "flag" : tokens[2];
+    argument.is_help = is_help;
+    argument.line = line_number;
+
+    for (size_t i = first_option; i < tokens.size(); ++i) {
+        std::string_view token = tokens[i];
+        size_t equal_sign_index = token.find('=');
+        std::string_view key = token.substr(0, equal_sign_index);
+        std::string_view value = (equal_sign_index == std::string_view::npos) ? std::string_view()
+                                                                               : token.substr(equal_sign_index + 1);
+
+        if (key == "short" && value.size() == 1) {
+            argument.short_name = value[0];
+        } else if (key == "default" && !is_help) {
+            argument.default_value = std::string(value);
+        } else if (key == "description") {
+            argument.description = value;
+        } else if (key == "positional" && !is_help) {
+            argument.is_positional = true;
+        } else if (key == "multi" && !is_help) {
+            argument.is_multi_value = true;
+
+            if (!value.empty()) {
+                argument.minimum_values = std::strtoull(std::string(value).c_str(), nullptr, 10);
+            }
+        } else {
+            throw SchemaError(line_number, "unknown option '" + std::string(token) + "'");
+        }
+    }
+
+    return argument;
+}
+
+Schema ReadSchema(std::istream& input) {
+    Schema schema;
+    std::string line;
+
+    for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+        std::vector<std::string> tokens = SplitLine(line, line_number);
+
+        if (tokens.empty()) {
+            continue;
+        }
+
+        if (tokens[0] == "program" && tokens.size() >= 2) {
+            schema.program_name = tokens[1];
+
+            for (size_t i = 2; i < tokens.size(); ++i) {
+                if (!tokens[i].starts_with("description=")) {
+                    throw SchemaError(line_number, "unknown option '" + tokens[i] + "'");
+                }
+
+                schema.program_description = tokens[i].substr(std::string_view("description=").size());
+            }
+        } else if (tokens[0] == "namespace" && tokens.size() == 2) {
+            schema.namespace_name = tokens[1];
+        } else if (tokens[0] == "argument" || tokens[0] == "help") {
+            schema.arguments.push_back(ParseArgument(tokens, line_number, tokens[0] == "help"));
+        } else {
+            throw SchemaError(line_number, "unknown declaration '" + tokens[0] + "'");
+        }
+    }
+
+    return schema;
+}
+
+std::string EscapeString(std::string_view value) {
+    std::string result = "\"";
+
+    for (char symbol : value) {
+        switch (symbol) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(symbol) < 0x20) {
+                    // Three octal digits, so that the next symbol is never taken into the escape
+                    char escape[5] = {'\\', static_cast<char>('0' + ((symbol >> 6) & 7)),
+                                      static_cast<char>('0' + ((symbol >> 3) & 7)), static_cast<char>('0' + (symbol & 7)), 0};
+                    result += escape;
+                } else {
+                    result += symbol;
+                }
+        }
+    }
+
+    return result + '"';
+}
+
+std::string EscapeChar(char symbol) {
+    if (symbol == '\'') {
+        return "'\\''";
+    }
+
+    std::string escaped = EscapeString(std::string_view(&symbol, 1));
+    return "'" + escaped.substr(1, escaped.size() - 2) + "'";
+}
+
+// Flags are set without a value in the argv, so their defaults are written as "true" and "false"
+template<typename T>
+std::optional<T> ParseDefault(std::string_view value_string) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (value_string != "true" && value_string != "false") {
+            return std::nullopt;
+        }
+
+        return value_string == "true";
+    } else {
+        return ParseValue<T>(value_string);
+    }
+}
+
+// The C++ literal of a default value, nullopt if the value is invalid for the type
+template<typename T>
+std::optional<std::string> GetLiteral(std::string_view value_string) {
+    std::optional<T> value = ParseDefault<T>(value_string);
+
+    if (!value.has_value()) {
+        return std::nullopt;
+    }
+
+    if constexpr (std::is_same_v<T, bool>) {
+        return *value ? "true" : "false";
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return EscapeString(*value);
+    } else if constexpr (std::is_same_v<T, char>) {
+        return EscapeChar(*value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        if (!std::isfinite(*value)) {
+            return std::nullopt;
+        }
+
+        std::string literal = FormatValue(*value);
+
+        if (literal.find_first_of(".e") == std::string::npos) {
+            literal += ".0";
+        }
+
+        return std::is_same_v<T, float> ? literal + "f" : std::is_same_v<T, long double> ? literal + "L" : literal;
+    } else {
+        return std::is_unsigned_v<T> ? FormatValue(*value) + "u" : FormatValue(*value);
+    }
+}
+
+template<typename T>
+void AddToParser(ArgParser& parser, const ArgumentSchema& schema) {
+    if (schema.is_help) {
+        parser.AddHelp(schema.short_name, schema.long_name, schema.description);
+        return;
+    }
+
+    SpecificArgument<T>& argument = parser.AddArgument<T>(schema.short_name, schema.long_name, schema.description);
+
+    if (schema.default_value.has_value()) {
+        argument.Default(*ParseDefault<T>(*schema.default_value));
+    }
+
+    if (schema.is_multi_value) {
+        argument.MultiValue(schema.minimum_values);
+    }
+
+    if (schema.is_positional) {
+        argument.Positional();
+    }
+}
+
+struct TypeInfo {
+    std::string_view name;
+    std::string_view cpp_type;
+    std::optional<std::string> (*get_literal)(std::string_view value_string);
+    void (*add_to_parser)(ArgParser& parser, const ArgumentSchema& schema);
+};
+
+template<typename T>
+constexpr TypeInfo MakeTypeInfo(std::string_view name, std::string_view cpp_type) {
+    return TypeInfo{name, cpp_type, &GetLiteral<T>, &AddToParser<T>};
+}
+
+const TypeInfo kTypes[] = {
+    MakeTypeInfo<bool>("flag", "bool"),
+    MakeTypeInfo<int32_t>("int", "int32_t"),
+    MakeTypeInfo<int32_t>("int32", "int32_t"),
+    MakeTypeInfo<int64_t>("int64", "int64_t"),
+    MakeTypeInfo<int16_t>("int16", "int16_t"),
+    MakeTypeInfo<uint64_t>("uint64", "uint64_t"),
+    MakeTypeInfo<uint32_t>("uint32", "uint32_t"),
+    MakeTypeInfo<uint16_t>("uint16", "uint16_t"),
+    MakeTypeInfo<uint8_t>("uint8", "uint8_t"),
+    MakeTypeInfo<double>("double", "double"),
+    MakeTypeInfo<float>("float", "float"),
+    MakeTypeInfo<long double>("long-double", "long double"),
+    MakeTypeInfo<std::string>("string", "std::string"),
+    MakeTypeInfo<char>("char", "char"),
+};
+
+const TypeInfo& GetTypeInfo(const ArgumentSchema& argument) {
+    for (const TypeInfo& type : kTypes) {
+        if (type.name == argument.type) {
+            return type;
+        }
+    }
+
+    throw SchemaError(argument.line, "unknown type '" + argument.type + "'");
+}
+
+void CheckSchema(const Schema& schema) {
+    std::set<std::string_view> long_names;
+    std::set<std::string_view> field_names;
+    std::set<char> short_names;
+    size_t help_count = 0;
+
+    for (const ArgumentSchema& argument : schema.arguments) {
+        const TypeInfo& type = GetTypeInfo(argument);
+
+        if (argument.long_name.empty() || !long_names.insert(argument.long_name).second) {
+            throw SchemaError(argument.line, "duplicate argument '" + argument.long_name + "'");
+        }
+
+        if (!field_names.insert(argument.field_name).second) {
+            throw SchemaError(argument.line, "the field name '" + argument.field_name + "' is already used");
+        }
+
+        if (argument.short_name != kNoShortName && !short_names.insert(argument.short_name).second) {
+            throw SchemaError(argument.line, std::string("duplicate short name '") + argument.short_name + "'");
+        }
+
+        if (argument.default_value.has_value() && !type.get_literal(*argument.default_value).has_value()) {
+            throw SchemaError(argument.line, "invalid default value '" + *argument.default_value + "'");
+        }
+
+        if (type.name == "flag" && (argument.is_positional || argument.is_multi_value)) {
+            throw SchemaError(argument.line, "a flag can't be positional or multi value");
+        }
+
+        if (argument.is_help && ++help_count > 1) {
+            throw SchemaError(argument.line, "more than one help argument");
+        }
+    }
+}
+
+PerfectHash BuildPerfectHash(const std::vector<std::string_view>& names) {
+    size_t buckets_count = std::max<size_t>(1, (names.size() + kNamesPerBucket - 1) / kNamesPerBucket);
+    size_t slots_count = std::bit_ceil(std::max<size_t>(1, names.size() + names.size() / 4));
+
+    std::vector<std::vector<size_t>> buckets(buckets_count);
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        buckets[HashName(names[i], 0) % buckets_count].push_back(i);
+    }
+
+    // The biggest buckets are placed first, while there are many free slots
+    std::vector<size_t> order(buckets_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    for (;; slots_count *= 2) {
+        PerfectHash hash{std::vector<uint32_t>(buckets_count, 0), std::vector<int32_t>(slots_count, -1)};
+        std::vector<size_t> bucket_slots;
+        bool is_built = true;
+
+        for (size_t bucket : order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+
+            bool is_placed = false;
+
+            for (uint32_t seed = 1; seed < kMaxSeed && !is_placed; ++seed) {
+                bucket_slots.clear();
+                is_placed = true;
+
+                for (size_t name_index : buckets[bucket]) {
+                    size_t slot = HashName(names[name_index], seed) & (slots_count - 1);
+
+                    if (hash.slots[slot] != -1
+                        || std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+                        is_placed = false;
+                        break;
+                    }
+
+                    bucket_slots.push_back(slot);
+                }
+
+                if (is_placed) {
+                    hash.seeds[bucket] = seed;
+
+                    for (size_t i = 0; i < bucket_slots.size(); ++i) {
+                        hash.slots[bucket_slots[i]] = static_cast<int32_t>(buckets[bucket][i]);
+                    }
+                }
+            }
+
+            if (!is_placed) {
+                is_built = false;
+                break;
+            }
+        }
+
+        if (is_built) {
+            return hash;
+        }
+    }
+}
+
+std::string RenderHelp(const Schema& schema) {
+    ArgParser parser(schema.program_name, schema.program_description);
+
+    for (const ArgumentSchema& argument : schema.arguments) {
+        GetTypeInfo(argument).add_to_parser(parser, argument);
+    }
+
+    return parser.HelpDescription();
+}
+
+template<typename T>
+void WriteArray(std::ostream& output, std::string_view type, std::string_view name, const std::vector<T>& values) {
+    output << "    static constexpr std::array<" << type << ", " << values.size() << "> " << name << " = {";
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        output << (i % 16 == 0 ? "\n        " : " ") << values[i] << ',';
+    }
+
+    output << "\n    };\n\n";
+}
+
+void WriteParser(std::ostream& output, const Schema& schema, std::string_view schema_path) {
+    const std::vector<ArgumentSchema>& arguments = schema.arguments;
+
+    std::vector<std::string_view> long_names;
+    std::vector<size_t> positional_arguments;
+    size_t help_index = kNoGeneratedHelp;
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        long_names.push_back(arguments[i].long_name);
+
+        if (arguments[i].is_positional) {
+            positional_arguments.push_back(i);
+        }
+
+        if (arguments[i].is_help) {
+            help_index = i;
+        }
+    }
+
+    PerfectHash hash = BuildPerfectHash(long_names);
+
+    output << "// Generated by argparser-gen from " << schema_path << ", don't edit.\n"
+              "#pragma once\n"
+              "\n"
+              "#include \"lib/GeneratedParser.hpp\"\n"
+              "\n"
+              "#include <array>\n"
+              "#include <cstddef>\n"
+              "#include <cstdint>\n"
+              "#include <optional>\n"
+              "#include <span>\n"
+              "#include <string>\n"
+              "#include <string_view>\n"
+              "#include <vector>\n"
+              "\n"
+              "namespace " << schema.namespace_name << " {\n"
+              "\n"
+              "struct Options {\n";
+
+    for (const ArgumentSchema& argument : arguments) {
+        const TypeInfo& type = GetTypeInfo(argument);
+
+        if (argument.is_multi_value) {
+            output << "    std::vector<" << type.cpp_type << "> " << argument.field_name << ";\n";
+            continue;
+        }
+
+        std::string initializer = argument.default_value.has_value() ? *type.get_literal(*argument.default_value) : "{}";
+
+        if (type.name == "flag" && !argument.default_value.has_value()) {
+            initializer = "false";
+        }
+
+        output << "    " << type.cpp_type << ' ' << argument.field_name << " = " << initializer << ";\n";
+    }
+
+    output << "};\n"
+              "\n"
+              "struct Schema {\n"
+              "    using Options = " << schema.namespace_name << "::Options;\n"
+              "\n"
+              "    static constexpr std::array<ArgumentParser::GeneratedArgument, " << arguments.size() << "> kArguments = {{\n";
+
+    for (const ArgumentSchema& argument : arguments) {
+        bool is_flag = GetTypeInfo(argument).name == "flag";
+        std::string short_name = (argument.short_name == kNoShortName) ? "ArgumentParser::kNoShortName"
+                                                                        : EscapeChar(argument.short_name);
+
+        output << "        {" << EscapeString(argument.long_name) << ", " << short_name << ", "
+               << std::boolalpha << is_flag << ", " << argument.is_positional << ", " << argument.is_multi_value << ", "
+               << (is_flag || argument.default_value.has_value()) << ", " << argument.minimum_values << "},\n";
+    }
+
+    output << "    }};\n"
+              "\n";
+
+    WriteArray(output, "size_t", "kPositionalArguments", positional_arguments);
+
+    output << "    static constexpr size_t kHelpIndex = "
+           << (help_index == kNoGeneratedHelp ? std::string("ArgumentParser::kNoGeneratedHelp") : std::to_string(help_index))
+           << ";\n"
+              "\n";
+
+    WriteArray(output, "uint32_t", "kHashSeeds", hash.seeds);
+    WriteArray(output, "int32_t", "kHashSlots", hash.slots);
+
+    output << "    static constexpr std::string_view kHelpDescription =";
+
+    std::string help = RenderHelp(schema);
+
+    for (size_t start = 0; start < help.size();) {
+        size_t end = std::min(help.find('\n', start), help.size() - 1) + 1;
+        output << "\n        " << EscapeString(std::string_view(help).substr(start, end - start));
+        start = end;
+    }
+
+    output << (help.empty() ? " \"\";\n" : ";\n")
+           << "\n"
+              "    static constexpr std::optional<size_t> FindShortName(char short_name) {\n"
+              "        switch (short_name) {\n";
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (arguments[i].short_name != kNoShortName) {
+            output << "            case " << EscapeChar(arguments[i].short_name) << ":\n"
+                      "                return " << i << ";\n";
+        }
+    }
+
+    output << "            default:\n"
+              "                return std::nullopt;\n"
+              "        }\n"
+              "    }\n"
+              "\n"
+              "    static bool SetValue([[maybe_unused]] Options& options, size_t index, [[maybe_unused]] std::string_view value_string) {\n"
+              "        switch (index) {\n";
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        const char* function = arguments[i].is_multi_value ? "AppendGeneratedValue" : "AssignGeneratedValue";
+
+        output << "            case " << i << ":\n"
+                  "                return ArgumentParser::" << function << "(options." << arguments[i].field_name
+               << ", value_string);\n";
+    }
+
+    output << "            default:\n"
+              "                return false;\n"
+              "        }\n"
+              "    }\n"
+              "\n"
+              "    static void FinishValues([[maybe_unused]] Options& options, [[maybe_unused]] std::span<const size_t> values_set) {\n";
+
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        if (arguments[i].is_multi_value && arguments[i].default_value.has_value()) {
+            output << "        if (values_set[" << i << "] == 0) {\n"
+                      "            options." << arguments[i].field_name << ".push_back("
+                   << *GetTypeInfo(arguments[i]).get_literal(*arguments[i].default_value) << ");\n"
+                      "        }\n";
+        }
+    }
+
+    output << "    }\n"
+              "};\n"
+              "\n"
+              "using Parser = ArgumentParser::GeneratedParser<Schema>;\n"
+              "\n"
+              "} // namespace " << schema.namespace_name << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <schema file> <output header>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1]);
+
+    if (!input) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ostringstream source;
+
+    try {
+        Schema schema = ReadSchema(input);
+        CheckSchema(schema);
+        WriteParser(source, schema, argv[1]);
+    } catch (const SchemaError& error) {
+        std::cerr << argv[1] << ':' << error.GetLine() << ": " << error.GetMessage() << std::endl;
+        return 1;
+    }
+
+    std::filesystem::path output_path(argv[2]);
+    std::error_code error_code;
+
+    if (output_path.has_parent_path()) {
+        std::filesystem::create_directories(output_path.parent_path(), error_code);
+    }
+
+    std::ofstream output(output_path);
+    output << source.str();
+
+    if (!output) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
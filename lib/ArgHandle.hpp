@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ArgumentParser {
+
+class ArgParser;
+
+template<typename T>
+class SpecificArgument;
+
+// A typed reference to an argument of a parser.
+// The value is accessed by the index of the argument, without a lookup by name,
+// and the type of the value is checked at compile time. Every argument added to any parser gets a new generation,
+// so a handle of another parser or of a replaced argument gives no value instead of a wrong one.
+template<typename T>
+class ArgHandle {
+public:
+    ArgHandle() = default;
+
+    size_t GetIndex() const {
+        return index_;
+    }
+
+    bool IsValid() const {
+        return index_ != kInvalidIndex;
+    }
+
+private:
+    static constexpr size_t kInvalidIndex = std::numeric_limits<size_t>::max();
+
+    size_t index_ = kInvalidIndex;
+    uint64_t generation_ = 0;
+
+    ArgHandle(size_t index, uint64_t generation)
+        : index_(index),
+          generation_(generation) {}
+
+    friend class ArgParser;
+    friend class SpecificArgument<T>;
+};
+
+} // namespace ArgumentParser
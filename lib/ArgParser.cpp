@@ -1,13 +1,16 @@
 #include "ArgParser.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
+#include <ranges>
+#include <utility>
 
 namespace ArgumentParser {
     
-ArgParser::ArgParser(const std::string& program_name, const std::string& program_description) 
-    : program_name_(program_name),
-      program_description_(program_description) {
+ARGPARSER_INLINE ArgParser::ArgParser(const std::string& program_name, const std::string& program_description) 
+    : program_name_(program_name, &schema_memory_),
+      program_description_(program_description, &schema_memory_) {
     help_description_types_ = {
         {typeid(int32_t).name(), "int"},
         {typeid(int64_t).name(), "long long"},
@@ -23,18 +26,32 @@ ArgParser::ArgParser(const std::string& program_name, const std::string& program
 
         {typeid(std::string).name(), "string"},
         {typeid(char).name(), "char"},
+        {typeid(KeyValueMap).name(), "key=value"},
+        {typeid(std::filesystem::path).name(), "path"},
         
         {typeid(bool).name(), ""},
     };
 }
 
-ArgParser::~ArgParser() {
+ARGPARSER_INLINE uint64_t ArgParser::GetNextGeneration() {
+    static std::atomic<uint64_t> next_generation = 1;
+    return next_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+ARGPARSER_INLINE ArgParser::~ArgParser() {
     for (auto* argument : arguments_) {
-        delete argument;
+        argument->Destroy(&schema_memory_);
     }
 }
 
-void ArgParser::RefreshParser() {
+ARGPARSER_INLINE void ArgParser::RefreshParser() {
+    if (use_defined_options_) {
+        AddDefinedOptions();
+    }
+
+    parse_memory_.ResetPeak();
+    flags_.Clear();
+
     for (auto* argument : arguments_) {
         argument->Clear();
     }
@@ -42,7 +59,9 @@ void ArgParser::RefreshParser() {
     error_ = ParsingError{};
 }
 
-std::vector<std::string_view> ArgParser::GetLongNames(std::string_view argument) const {
+ARGPARSER_INLINE void ArgParser::GetLongNames(std::string_view argument, std::pmr::vector<std::string_view>& names) const {
+    names.clear();
+
     bool is_long = false;
 
     if (argument.starts_with("--")) {
@@ -55,40 +74,203 @@ std::vector<std::string_view> ArgParser::GetLongNames(std::string_view argument)
     size_t equal_sign_index = argument.find('=');
     argument = argument.substr(0, equal_sign_index);
 
-    std::vector<std::string_view> names;
-
     if (is_long) {
         names.push_back(argument);
-    } else if (equal_sign_index != std::string_view::npos && argument.length() > 1) {
-        return {};
-    } else {
-        for (const char short_name : argument) {
-            if (!short_names_to_long_.contains(short_name)) {
-                continue;
-            }
+        return;
+    }
+
+    // "-Dkey=value" is a short option with the attached value "key=value"
+    if (equal_sign_index != std::string_view::npos && argument.length() > 1) {
+        auto it = short_names_to_long_.find(argument[0]);
 
-            names.push_back(short_names_to_long_.at(short_name));
+        if (it != short_names_to_long_.end()) {
+            names.push_back(it->second);
         }
+
+        return;
     }
 
-    if (!is_long && names.size() < argument.length()) {
-        if (short_names_to_long_.contains(argument[0])) {
-            return {names[0]};
+    for (const char short_name : argument) {
+        auto it = short_names_to_long_.find(short_name);
+
+        if (it != short_names_to_long_.end()) {
+            names.push_back(it->second);
         }
+    }
 
-        return {};
+    if (names.size() < argument.length()) {
+        bool is_first_known = short_names_to_long_.contains(argument[0]);
+        names.resize(is_first_known ? 1 : 0);
+    }
+}
+
+ARGPARSER_INLINE void ArgParser::AllowAbbreviations(bool allow) {
+    allow_abbreviations_ = allow;
+}
+
+ARGPARSER_INLINE void ArgParser::ValidateUtf8(bool validate) {
+    validate_utf8_ = validate;
+}
+
+ARGPARSER_INLINE void ArgParser::UseDefinedOptions() {
+    use_defined_options_ = true;
+}
+
+ARGPARSER_INLINE void ArgParser::AddDefinedOptions() {
+    use_defined_options_ = false;
+
+    std::vector<OptionNode*> options;
+    ForEachDefinedOption([&options](OptionNode& option) {
+        options.push_back(&option);
+    });
+
+    // The order of the linked objects isn't stable, so the help lists the options by name
+    std::ranges::sort(options, {}, &OptionNode::long_name);
+
+    for (OptionNode* option : options) {
+        option->add_to_parser(*this, *option);
+    }
+}
+
+ARGPARSER_INLINE bool ArgParser::ValidateArgvUtf8(std::span<const std::string_view> argv) {
+    if (argv.size() < 2) {
+        return true;
+    }
+
+    // The argv given to main is usually stored in one area, the tokens are separated by '\0'.
+    // Then the whole area is checked in one pass, and the tokens are checked one by one only to find the invalid one
+    bool is_contiguous = true;
+
+    for (size_t i = 2; i < argv.size() && is_contiguous; ++i) {
+        const char* end = argv[i - 1].data() + argv[i - 1].size();
+        is_contiguous = argv[i].data() == end + 1 && static_cast<unsigned char>(*end) < 0x80;
+    }
+
+    if (is_contiguous) {
+        const char* begin = argv[1].data();
+        const char* end = argv.back().data() + argv.back().size();
+
+        if (IsValidUtf8(std::string_view(begin, end - begin))) {
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < argv.size(); ++i) {
+        if (!IsValidUtf8(argv[i])) {
+            error_ = ParsingError{argv[i], ParsingErrorType::kInvalidArgument};
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ARGPARSER_INLINE void ArgParser::BuildNamesIndex() const {
+    if (is_names_index_valid_) {
+        return;
+    }
+
+    sorted_long_names_.clear();
+    sorted_long_names_.reserve(arguments_.size());
+
+    for (const Argument* argument : arguments_) {
+        if (!argument->IsPositional()) {
+            sorted_long_names_.push_back(argument->GetLongName());
+        }
+    }
+
+    std::sort(sorted_long_names_.begin(), sorted_long_names_.end());
+
+    long_names_by_length_ = sorted_long_names_;
+    std::stable_sort(long_names_by_length_.begin(), long_names_by_length_.end(),
+        [](std::string_view lhs, std::string_view rhs) {
+            return lhs.length() < rhs.length();
+        }
+    );
+
+    is_names_index_valid_ = true;
+}
+
+ARGPARSER_INLINE void ArgParser::BuildCaches() const {
+    BuildNamesIndex();
+
+    for (const Argument* argument : arguments_) {
+        argument->GetDefaultValueString();
+    }
+}
+
+ARGPARSER_INLINE std::span<const std::string_view> ArgParser::GetAbbreviationCandidates(std::string_view prefix) const {
+    auto [first, last] = std::equal_range(
+        sorted_long_names_.begin(),
+        sorted_long_names_.end(),
+        prefix,
+        [length = prefix.length()](std::string_view lhs, std::string_view rhs) {
+            return lhs.substr(0, length) < rhs.substr(0, length);
+        }
+    );
+
+    return {first, last};
+}
+
+ARGPARSER_INLINE std::vector<std::string_view> ArgParser::GetSuggestions(std::string_view argument,
+                                                                         size_t max_suggestions,
+                                                                         size_t max_distance) const {
+    while (argument.starts_with('-')) {
+        argument.remove_prefix(1);
+    }
+
+    argument = argument.substr(0, argument.find('='));
+
+    BuildNamesIndex();
+
+    size_t min_length = (argument.length() > max_distance) ? argument.length() - max_distance : 0;
+    size_t max_length = argument.length() + max_distance;
+
+    auto first = std::lower_bound(long_names_by_length_.begin(), long_names_by_length_.end(), min_length,
+        [](std::string_view name, size_t length) {
+            return name.length() < length;
+        }
+    );
+
+    EditDistanceMatcher matcher(argument);
+    std::vector<std::pair<size_t, std::string_view>> matches;
+
+    for (auto it = first; it != long_names_by_length_.end() && it->length() <= max_length; ++it) {
+        std::optional<size_t> distance = matcher.Distance(*it, max_distance);
+
+        if (distance.has_value()) {
+            matches.emplace_back(distance.value(), *it);
+        }
     }
 
-    return names;
+    size_t suggestions_count = std::min(max_suggestions, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + suggestions_count, matches.end());
+
+    std::vector<std::string_view> suggestions;
+    suggestions.reserve(suggestions_count);
+
+    for (size_t i = 0; i < suggestions_count; ++i) {
+        suggestions.push_back(matches[i].second);
+    }
+
+    return suggestions;
 }
 
-bool ArgParser::Parse(const std::vector<std::string_view>& argv) {
+ARGPARSER_INLINE bool ArgParser::Parse(std::span<const std::string_view> argv) {
     RefreshParser();
 
-    std::vector<size_t> unused_positions;
+    int stream_fd = std::exchange(positional_fd_, -1);
+
+    if (validate_utf8_ && !ValidateArgvUtf8(argv)) {
+        return false;
+    }
+
+    std::pmr::vector<size_t>& unused_positions = unused_positions_;
+    unused_positions.clear();
 
     for (size_t position = 1; position < argv.size(); ++position) {
         std::string_view argument = argv[position];
+        PhaseTimer classification_timer(observer_, ParsePhase::kTokenClassification);
 
         if (argument.empty()) {
             continue;
@@ -109,7 +291,11 @@ bool ArgParser::Parse(const std::vector<std::string_view>& argv) {
             continue;
         }
 
-        std::vector<std::string_view> long_names = GetLongNames(argument);
+        classification_timer.Stop();
+        PhaseTimer lookup_timer(observer_, ParsePhase::kNameLookup);
+
+        std::pmr::vector<std::string_view>& long_names = long_names_;
+        GetLongNames(argument, long_names);
 
         if (long_names.empty()) {
             error_ = {argv[position], ParsingErrorType::kUnknownArgument};
@@ -117,28 +303,50 @@ bool ArgParser::Parse(const std::vector<std::string_view>& argv) {
         }
 
         if (argument[1] != '-' && argument.length() > 2 && long_names.size() == 1) {
-            Argument* argument = arguments_[arguments_indeces_[std::string(long_names[0])]];
+            Argument* argument = arguments_[arguments_indeces_.find(long_names[0])->second];
             if (argument->IsFlag()) {
                 error_ = ParsingError{argv[position], ParsingErrorType::kUnknownArgument, long_names[0]};
                 return false;
             }
         }
 
+        if (allow_abbreviations_ && argument[1] == '-' && !long_names[0].empty()
+            && !arguments_indeces_.contains(long_names[0])) {
+            BuildNamesIndex();
+
+            std::span<const std::string_view> candidates = GetAbbreviationCandidates(long_names[0]);
+
+            if (candidates.size() > 1) {
+                error_ = ParsingError{argv[position], ParsingErrorType::kAmbiguousArgument, long_names[0], candidates};
+                return false;
+            }
+
+            if (candidates.size() == 1) {
+                long_names[0] = candidates[0];
+            }
+        }
+
+        lookup_timer.SetCount(long_names.size());
+        lookup_timer.Stop();
+
         for (std::string_view long_name : long_names) {
-            std::string name{long_name};
+            PhaseTimer index_lookup_timer(observer_, ParsePhase::kNameLookup);
+            auto index_it = arguments_indeces_.find(long_name);
 
-            if (!arguments_indeces_.contains(name)) {
+            if (index_it == arguments_indeces_.end()) {
                 error_ = ParsingError{argv[position], ParsingErrorType::kUnknownArgument, long_name};
                 return false;
             }
 
-            size_t argument_index = arguments_indeces_.at(name);
+            size_t argument_index = index_it->second;
 
             if (arguments_[argument_index]->IsPositional()) {
                 error_ = ParsingError{argv[position], ParsingErrorType::kUnknownArgument, long_name};
                 return false;
             }
 
+            index_lookup_timer.Stop();
+
             std::expected<size_t, ParsingError> current_used_positions 
                 = arguments_[argument_index]->ParseArgument(argv, position);
 
@@ -157,18 +365,25 @@ bool ArgParser::Parse(const std::vector<std::string_view>& argv) {
 
     ParsePositionalArguments(argv, unused_positions);
 
+    if (stream_fd >= 0 && error_.status == ParsingErrorType::kSuccess) {
+        ParsePositionalStream(stream_fd, positional_delimiter_);
+    }
+
     if (need_help_) {
         HandleErrors();
         return true;
     }
 
-    return HandleErrors();
+    return HandleErrors() && CheckPaths();
 }
 
-void ArgParser::ParsePositionalArguments(const std::vector<std::string_view>& argv,
-                                         const std::vector<size_t>& positions) {
-    std::vector<size_t> positional_args_indeces;
-    std::vector<std::string_view> positional_args;
+ARGPARSER_INLINE void ArgParser::ParsePositionalArguments(std::span<const std::string_view> argv,
+                                                          std::span<const size_t> positions) {
+    PhaseTimer positional_timer(observer_, ParsePhase::kPositionalAssignment);
+    positional_timer.SetCount(positions.size());
+
+    std::pmr::vector<size_t>& positional_args_indeces = positional_args_indeces_;
+    positional_args_indeces.clear();
 
     for (size_t i = 0; i < arguments_.size(); ++i) {
         if (arguments_[i]->IsPositional()) {
@@ -176,12 +391,8 @@ void ArgParser::ParsePositionalArguments(const std::vector<std::string_view>& ar
         }
     }
 
-    for (size_t i = 0; i < positions.size(); ++i) {
-        positional_args.push_back(argv[positions[i]]);
-    }
-
     if (positional_args_indeces.empty()) {
-        if (!positional_args.empty()) {
+        if (!positions.empty()) {
             error_ = ParsingError{argv[positions[0]], ParsingErrorType::kUnknownArgument};
         }
 
@@ -194,8 +405,8 @@ void ArgParser::ParsePositionalArguments(const std::vector<std::string_view>& ar
         Argument* argument = arguments_[positional_args_indeces[argument_index]];
         if (argument->IsMultiValue()) {
             while (position_index < positions.size()) {
-                std::expected<size_t, ParsingError> current_used_positions 
-                    = argument->ParseArgument(argv, positions[position_index]);
+                std::expected<size_t, ParsingError> current_used_positions
+                    = ParsePositionalValue(argument, argv, positions[position_index]);
 
                 if (!current_used_positions.has_value()) {
                     error_ = current_used_positions.error();
@@ -208,8 +419,8 @@ void ArgParser::ParsePositionalArguments(const std::vector<std::string_view>& ar
             return;
         }
 
-        std::expected<size_t, ParsingError> current_used_positions 
-            = argument->ParseArgument(argv, positions[position_index]);
+        std::expected<size_t, ParsingError> current_used_positions
+            = ParsePositionalValue(argument, argv, positions[position_index]);
 
         if (!current_used_positions.has_value()) {
             error_ = current_used_positions.error();
@@ -218,29 +429,79 @@ void ArgParser::ParsePositionalArguments(const std::vector<std::string_view>& ar
     }
 }
 
-bool ArgParser::Parse(int argc, char **argv) {
-    std::vector<std::string_view> new_argv;
-    new_argv.reserve(argc);
+ARGPARSER_INLINE void ArgParser::ReadPositionalFrom(int fd, char delimiter) {
+    positional_fd_ = fd;
+    positional_delimiter_ = delimiter;
+}
 
-    for (size_t i = 0; i < argc; ++i) {
-        new_argv.push_back(argv[i]);
+ARGPARSER_INLINE std::expected<size_t, ParsingError> ArgParser::ParsePositionalValue(
+    Argument* argument,
+    std::span<const std::string_view> argv,
+    size_t position) {
+    if (argument->IsGlob() && IsGlobPattern(argv[position])) {
+        return argument->ParseGlob(argv[position], glob_expander_);
     }
 
-    return Parse(new_argv);
+    return argument->ParseArgument(argv, position);
 }
 
-bool ArgParser::Parse(const std::vector<std::string>& argv) {
-    std::vector<std::string_view> new_argv;
-    new_argv.reserve(argv.size());
+ARGPARSER_INLINE void ArgParser::ParsePositionalStream(int fd, char delimiter) {
+    auto argument_it = std::find_if(arguments_.begin(), arguments_.end(), [](const Argument* argument) {
+        return argument->IsPositional() && argument->IsMultiValue();
+    });
 
-    for (size_t i = 0; i < argv.size(); ++i) {
-        new_argv.push_back(argv[i]);
+    if (argument_it == arguments_.end()) {
+        error_ = ParsingError{std::string_view(), ParsingErrorType::kNoStreamArgument};
+        return;
     }
 
-    return Parse(new_argv);
+    Argument* argument = *argument_it;
+    DelimitedStreamReader reader(fd, delimiter);
+
+    bool is_read = reader.ForEachToken([this, argument](std::string_view token) {
+        if (validate_utf8_ && !IsValidUtf8(token)) {
+            stream_error_token_ = token;
+            error_ = ParsingError{stream_error_token_, ParsingErrorType::kInvalidArgument, argument->GetLongName()};
+            return false;
+        }
+
+        std::expected<size_t, ParsingError> used_positions
+            = argument->ParseArgument(std::span<const std::string_view>(&token, 1), 0);
+
+        if (!used_positions.has_value()) {
+            stream_error_token_ = token;
+            error_ = used_positions.error();
+            error_.argument_string = stream_error_token_;
+            return false;
+        }
+
+        return true;
+    });
+
+    if (!is_read && error_.status == ParsingErrorType::kSuccess) {
+        error_ = ParsingError{std::string_view(), ParsingErrorType::kStreamReadError, argument->GetLongName()};
+        error_.error_number = reader.GetReadError();
+    }
+}
+
+ARGPARSER_INLINE bool ArgParser::Parse(int argc, char** argv) {
+    return Parse(std::span<const char* const>(argv, argc));
+}
+
+ARGPARSER_INLINE bool ArgParser::Parse(std::span<const char* const> argv) {
+    argv_.assign(argv.begin(), argv.end());
+    return Parse(std::span<const std::string_view>(argv_));
+}
+
+ARGPARSER_INLINE bool ArgParser::Parse(const std::vector<std::string>& argv) {
+    argv_.assign(argv.begin(), argv.end());
+    return Parse(std::span<const std::string_view>(argv_));
 }
 
-bool ArgParser::HandleErrors() {
+ARGPARSER_INLINE bool ArgParser::HandleErrors() {
+    PhaseTimer error_handling_timer(observer_, ParsePhase::kErrorHandling);
+    error_handling_timer.SetCount(arguments_.size());
+
     if (error_.status != ParsingErrorType::kSuccess) {
         return false;
     }
@@ -261,24 +522,169 @@ bool ArgParser::HandleErrors() {
         return false;
     }
 
+    return CheckConstraints();
+}
+
+ARGPARSER_INLINE bool ArgParser::CheckPaths() {
+    path_checks_.Clear();
+
+    for (Argument* argument : arguments_) {
+        argument->AddPathChecks(path_checks_);
+    }
+
+    if (path_checks_.Size() == 0) {
+        return true;
+    }
+
+    path_checks_.Run();
+
+    // Fetched once for all the paths, the permission checks don't make system calls
+    UserCredentials credentials = UserCredentials::GetCurrent();
+
+    for (Argument* argument : arguments_) {
+        std::expected<void, ParsingError> result = argument->TakePathChecks(path_checks_, credentials);
+
+        if (!result.has_value()) {
+            error_ = result.error();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ARGPARSER_INLINE std::span<const PathMetadata> ArgParser::GetPathMetadata(const std::string& long_name) const {
+    const SpecificArgument<std::filesystem::path>* argument = FindArgument<std::filesystem::path>(long_name);
+
+    if (argument == nullptr) {
+        return {};
+    }
+
+    return argument->GetMetadata();
+}
+
+ARGPARSER_INLINE void ArgParser::AddExclusiveGroup(std::initializer_list<std::string_view> long_names, bool is_required) {
+    constraints_.emplace_back(Constraint::Kind::kExclusiveGroup, std::string_view(), long_names, is_required, &schema_memory_);
+    are_constraints_valid_ = false;
+}
+
+ARGPARSER_INLINE void ArgParser::AddDependency(std::string_view long_name,
+                                               std::initializer_list<std::string_view> required_long_names) {
+    constraints_.emplace_back(Constraint::Kind::kDependency, long_name, required_long_names, false, &schema_memory_);
+    are_constraints_valid_ = false;
+}
+
+ARGPARSER_INLINE bool ArgParser::BuildConstraints() {
+    present_arguments_.Resize(arguments_.size());
+
+    for (Constraint& constraint : constraints_) {
+        constraint.names.assign(constraint.names_storage.begin(), constraint.names_storage.end());
+        constraint.mask.Resize(arguments_.size());
+
+        // A misspelled name would make the rule never fire, so it's an error of every parse
+        for (std::string_view name : constraint.names) {
+            auto index_it = arguments_indeces_.find(name);
+
+            if (index_it == arguments_indeces_.end()) {
+                error_ = ParsingError{{}, ParsingErrorType::kUnknownConstraintArgument, name, constraint.names};
+                return false;
+            }
+
+            constraint.mask.Set(index_it->second);
+        }
+
+        if (constraint.kind == Constraint::Kind::kDependency) {
+            auto dependent_it = arguments_indeces_.find(std::string_view(constraint.dependent_name));
+
+            if (dependent_it == arguments_indeces_.end()) {
+                error_ = ParsingError{{},
+                                      ParsingErrorType::kUnknownConstraintArgument,
+                                      constraint.dependent_name,
+                                      constraint.names};
+                return false;
+            }
+
+            constraint.dependent_index = dependent_it->second;
+        }
+    }
+
+    are_constraints_valid_ = true;
     return true;
 }
 
-void ArgParser::AddHelp(char short_name, const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE bool ArgParser::CheckConstraints() {
+    if (constraints_.empty()) {
+        return true;
+    }
+
+    if (!are_constraints_valid_ && !BuildConstraints()) {
+        return false;
+    }
+
+    present_arguments_.Clear();
+
+    for (size_t i = 0; i < arguments_.size(); ++i) {
+        if (arguments_[i]->GetValuesSet() > 0) {
+            present_arguments_.Set(i);
+        }
+    }
+
+    for (const Constraint& constraint : constraints_) {
+        if (constraint.kind == Constraint::Kind::kDependency) {
+            if (!present_arguments_.Test(constraint.dependent_index)
+                || present_arguments_.Contains(constraint.mask)) {
+                continue;
+            }
+
+            error_ = ParsingError{{}, ParsingErrorType::kMissingDependency, constraint.dependent_name, constraint.names};
+            return false;
+        }
+
+        size_t present_count = present_arguments_.CountCommon(constraint.mask);
+
+        if (present_count > 1) {
+            error_ = ParsingError{{}, ParsingErrorType::kExclusiveArguments, {}, constraint.names};
+
+            // The name of the second argument set, which conflicts with the first one
+            for (std::string_view name : constraint.names | std::views::reverse) {
+                auto index_it = arguments_indeces_.find(name);
+
+                if (index_it != arguments_indeces_.end() && present_arguments_.Test(index_it->second)) {
+                    error_.argument_name = arguments_[index_it->second]->GetLongName();
+                    break;
+                }
+            }
+
+            return false;
+        }
+
+        if (present_count == 0 && constraint.is_required) {
+            error_ = ParsingError{{}, ParsingErrorType::kMissingGroupArgument, {}, constraint.names};
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ARGPARSER_INLINE void ArgParser::AddHelp(char short_name, const std::string& long_name, const std::string& description) {
     AddFlag(short_name, long_name, description);
     help_argument_name_ = long_name;
 }
 
-void ArgParser::AddHelp(const std::string& long_name, const std::string& description) {
+ARGPARSER_INLINE void ArgParser::AddHelp(const std::string& long_name, const std::string& description) {
     AddHelp(kNoShortName, long_name, description);
 }
 
-bool ArgParser::Help() const {
+ARGPARSER_INLINE bool ArgParser::Help() const {
     return need_help_;
 }
 
-std::string ArgParser::HelpDescription() const {
-    std::string result = program_name_ + '\n';
+ARGPARSER_INLINE std::string ArgParser::HelpDescription() const {
+    PhaseTimer help_timer(observer_, ParsePhase::kHelpRendering);
+
+    std::string result(program_name_);
+    result += '\n';
 
     size_t max_argument_names_length = 0;
 
@@ -294,14 +700,18 @@ std::string ArgParser::HelpDescription() const {
         result += '\n';
     }
 
-    result += "Usage: " + program_name_ + " [OPTIONS]";
+    result += "Usage: ";
+    result += program_name_;
+    result += " [OPTIONS]";
 
     for (const Argument* argument : arguments_) {
         if (!argument->IsPositional()) {
             continue;
         }
 
-        result += " <" + argument->GetLongName() + ">";
+        result += " <";
+        result += argument->GetLongName();
+        result += '>';
 
         if (argument->IsMultiValue()) {
             result += "...";
@@ -323,8 +733,8 @@ std::string ArgParser::HelpDescription() const {
     return result;
 }
 
-std::string ArgParser::GetArgumentDescription(const Argument* argument,
-                                              size_t max_argument_names_length) const {
+ARGPARSER_INLINE std::string ArgParser::GetArgumentDescription(const Argument* argument,
+                                                               size_t max_argument_names_length) const {
     std::string result = GetArgumentNamesDescription(argument);
 
     result.insert(result.end(), max_argument_names_length - result.length() + 2, ' ');
@@ -340,12 +750,32 @@ std::string ArgParser::GetArgumentDescription(const Argument* argument,
         is_first_option = false;
     }
 
-    if (argument->HasDefault() && argument->GetLongName() != help_argument_name_) {
+    if (!argument->GetChoices().empty()) {
         if (!is_first_option) {
             options += "; ";
         }
 
-        options += "default = " + argument->GetDefaultValueString();
+        options += "choices = ";
+
+        for (std::string_view choice : argument->GetChoices()) {
+            options += choice;
+            options += ", ";
+        }
+
+        options.resize(options.length() - 2);
+        is_first_option = false;
+    }
+
+    // A default which can't be formatted isn't shown
+    std::string_view default_value = argument->HasDefault() ? argument->GetDefaultValueString() : "";
+
+    if (!default_value.empty() && argument->GetLongName() != help_argument_name_) {
+        if (!is_first_option) {
+            options += "; ";
+        }
+
+        options += "default = ";
+        options += default_value;
     }
 
     options += ']';
@@ -357,7 +787,7 @@ std::string ArgParser::GetArgumentDescription(const Argument* argument,
     return result;
 }
 
-std::string ArgParser::GetArgumentNamesDescription(const Argument* argument) const {
+ARGPARSER_INLINE std::string ArgParser::GetArgumentNamesDescription(const Argument* argument) const {
     std::string result;
     if (argument->GetShortName() == kNoShortName) {
         result.insert(0, 4, ' ');
@@ -375,33 +805,87 @@ std::string ArgParser::GetArgumentNamesDescription(const Argument* argument) con
         result += "=<";
         result += help_description_types_.at(argument->GetType());
         result += ">";
+    } else if (argument->GetArity() > 1) {
+        // "--bbox <double> <double> <double> <double>"
+        auto alias_it = help_description_types_.find(argument->GetElementType());
+        std::string_view alias = (alias_it == help_description_types_.end()) ? "value" : std::string_view(alias_it->second);
+
+        for (size_t i = 0; i < argument->GetArity(); ++i) {
+            result += " <";
+            result += alias;
+            result += ">";
+        }
+    } else if (!argument->GetChoices().empty()) {
+        result += "=<choice>";
     }
 
     return result;
 }
 
-ParsingError ArgParser::GetError() const {
+ARGPARSER_INLINE void ArgParser::SetObserver(ParseObserver* observer) {
+    observer_ = observer;
+
+    for (auto* argument : arguments_) {
+        argument->SetObserver(observer);
+    }
+}
+
+ARGPARSER_INLINE ParsingError ArgParser::GetError() const {
     return error_;
 }
 
-bool ArgParser::HasError() const {
+ARGPARSER_INLINE bool ArgParser::HasError() const {
     return error_.status != ParsingErrorType::kSuccess;
 }
 
-std::optional<size_t> ArgParser::GetValuesSet(const std::string& long_name) const {
-    if (!arguments_indeces_.contains(long_name)) {
+ARGPARSER_INLINE std::optional<size_t> ArgParser::GetValuesSet(const std::string& long_name) const {
+    auto index_it = arguments_indeces_.find(std::string_view(long_name));
+
+    if (index_it == arguments_indeces_.end()) {
         return std::nullopt;
     }
 
-    return arguments_[arguments_indeces_.at(long_name)]->GetValuesSet();
+    return arguments_[index_it->second]->GetValuesSet();
 }
 
-std::optional<ArgumentStatus> ArgParser::GetValueStatus(const std::string& long_name) const {
-    if (!arguments_indeces_.contains(long_name)) {
+ARGPARSER_INLINE std::optional<ArgumentStatus> ArgParser::GetValueStatus(const std::string& long_name) const {
+    auto index_it = arguments_indeces_.find(std::string_view(long_name));
+
+    if (index_it == arguments_indeces_.end()) {
         return std::nullopt;
     }
 
-    return arguments_[arguments_indeces_.at(long_name)]->GetValueStatus();
+    return arguments_[index_it->second]->GetValueStatus();
+}
+
+ARGPARSER_INLINE std::vector<std::string_view> ArgParser::GetChangedArguments(const ArgParser& previous) const {
+    std::vector<std::string_view> changed;
+
+    for (const Argument* argument : arguments_) {
+        auto index_it = previous.arguments_indeces_.find(argument->GetLongName());
+
+        if (index_it == previous.arguments_indeces_.end()
+            || !argument->HasSameValues(*previous.arguments_[index_it->second])) {
+            changed.push_back(argument->GetLongName());
+        }
+    }
+
+    return changed;
+}
+
+ARGPARSER_INLINE ParserMemoryUsage ArgParser::MemoryUsage() const {
+    ParserMemoryUsage usage;
+    usage.schema_bytes = schema_memory_.GetBytes();
+    usage.parse_bytes = parse_memory_.GetBytes();
+    usage.parse_peak_bytes = parse_memory_.GetPeakBytes();
+
+    usage.arguments.reserve(arguments_.size());
+
+    for (const Argument* argument : arguments_) {
+        usage.arguments.push_back({argument->GetLongName(), argument->GetValuesMemoryUsage()});
+    }
+
+    return usage;
 }
 
 } // namespace ArgumentParser
@@ -1,12 +1,22 @@
 #pragma once
 
+#include "Constraints.hpp"
+#include "CountingMemoryResource.hpp"
+#include "DelimitedStreamReader.hpp"
+#include "GlobExpander.hpp"
+#include "KeyValueMap.hpp"
+#include "OptionRegistry.hpp"
+#include "PathCheck.hpp"
 #include "SpecificArgument.hpp"
 
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include <cstdint>
+#include <filesystem>
 #include <optional>
+#include <span>
 
 #define ARGPARSER_ADD_ARGUMENT(NewName, Type) \
 inline SpecificArgument<Type>& NewName(char short_name, \
@@ -27,6 +37,52 @@ inline Type NewName(const std::string& long_name, size_t index = 0) const { \
 
 namespace ArgumentParser {
 
+class ArgParser;
+
+// Binds the arguments of a parser to the fields of a caller-owned struct.
+// Parsing writes the values straight into the struct, so the struct is the whole result
+// and may be copied as a single object.
+template<typename Config>
+class StructBinder {
+public:
+    StructBinder(ArgParser& parser, Config& config) : parser_(parser), config_(config) {}
+
+    template<typename T>
+    SpecificArgument<T>& Bind(T Config::* field,
+                              const std::string& long_name,
+                              char short_name = kNoShortName,
+                              const std::string& description = "");
+
+    // A vector field receives all values of a multi value argument
+    template<typename T>
+    SpecificArgument<T>& Bind(std::vector<T> Config::* field,
+                              const std::string& long_name,
+                              char short_name = kNoShortName,
+                              const std::string& description = "");
+
+private:
+    ArgParser& parser_;
+    Config& config_;
+};
+
+struct ArgumentMemoryUsage {
+    std::string_view argument_name;
+    size_t values_bytes = 0;
+};
+
+// Bytes allocated through the parser's memory resources. The heap memory owned by the values themselves,
+// like the characters of long strings and paths, isn't counted, so it's a lower bound
+struct ParserMemoryUsage {
+    // The argument objects, the names, descriptions and default value strings, the maps and the help data
+    size_t schema_bytes = 0;
+
+    // The storage for values of all arguments (including the vector capacity) and the parsing buffers
+    size_t parse_bytes = 0;
+    size_t parse_peak_bytes = 0;
+
+    std::vector<ArgumentMemoryUsage> arguments;
+};
+
 class ArgParser {
 public:
     explicit ArgParser(const std::string& program_name, const std::string& program_description = "");
@@ -49,10 +105,33 @@ public:
     template<typename T>
     std::optional<T> GetValue(const std::string& long_name, size_t index = 0) const;
 
+    template<typename T>
+    std::optional<T> GetValue(ArgHandle<T> handle, size_t index = 0) const;
+
+    template<typename Config>
+    StructBinder<Config> BindStruct(Config& config);
+
+    template<typename T>
+    std::span<const T> GetValues(const std::string& long_name) const requires (!std::is_same_v<T, bool>);
+
+    template<typename T>
+    std::vector<T> TakeValues(const std::string& long_name) requires (!std::is_same_v<T, bool>);
+
+    template<typename T>
+    std::span<const T> Values(ArgHandle<T> handle) const requires (!std::is_same_v<T, bool>);
+
+    // The metadata collected by the checks of a path argument, in the order of its values
+    std::span<const PathMetadata> GetPathMetadata(const std::string& long_name) const;
+
     bool Parse(const std::vector<std::string>& argv);
-    bool Parse(const std::vector<std::string_view>& argv);
+    bool Parse(std::span<const std::string_view> argv);
+    bool Parse(std::span<const char* const> argv);
     bool Parse(int argc, char** argv);
 
+    // The next Parse also reads values of the multi-value positional argument from the file descriptor,
+    // separated by the delimiter: '\0' for `find -print0` and `xargs -0`, '\n' for lines
+    void ReadPositionalFrom(int fd, char delimiter = '\0');
+
     void AddHelp(char short_name,
                  const std::string& long_name,
                  const std::string& description = "");
@@ -63,6 +142,24 @@ public:
     bool Help() const;
     std::string HelpDescription() const;
 
+    void AllowAbbreviations(bool allow = true);
+
+    // Every token of the argv must be valid UTF-8, otherwise the parsing fails with kInvalidArgument
+    void ValidateUtf8(bool validate = true);
+
+    // The options defined by ARGPARSER_DEFINE_OPTION in any translation unit are added on the first Parse
+    void UseDefinedOptions();
+
+    // At most one of the arguments may be set, or exactly one if the group is required
+    void AddExclusiveGroup(std::initializer_list<std::string_view> long_names, bool is_required = false);
+
+    // If the argument is set, all the required arguments must be set too
+    void AddDependency(std::string_view long_name, std::initializer_list<std::string_view> required_long_names);
+
+    std::vector<std::string_view> GetSuggestions(std::string_view argument,
+                                                 size_t max_suggestions = 3,
+                                                 size_t max_distance = 2) const;
+
     ParsingError GetError() const;
     bool HasError() const;
 
@@ -71,6 +168,17 @@ public:
 
     std::optional<size_t> GetValuesSet(const std::string& long_name) const;
 
+    void SetObserver(ParseObserver* observer);
+
+    ParserMemoryUsage MemoryUsage() const;
+
+    // The names of the arguments whose values differ from the ones in the other parser
+    std::vector<std::string_view> GetChangedArguments(const ArgParser& previous) const;
+
+    // Fills the caches which the const methods build lazily: the index of the names and the formatted defaults.
+    // After it the const methods write nothing, so the parser may be read by several threads at once
+    void BuildCaches() const;
+
     // The following names are added only to match the interface in the tests.
     // They are unsafe, exceptions may be thrown.
     // It's better to use AddArgument<type> and GetValue<type> and check the return value.
@@ -86,56 +194,132 @@ public:
     ARGPARSER_GET_VALUE(GetDoubleValue, double);
 
 private:
-    std::string program_name_;
-    std::string program_description_;
+    // Declared first, so that they outlive everything allocated from them
+    CountingMemoryResource schema_memory_;
+    CountingMemoryResource parse_memory_;
+
+    std::pmr::string program_name_;
+    std::pmr::string program_description_;
 
-    std::vector<Argument*> arguments_;
+    std::pmr::vector<Argument*> arguments_{&schema_memory_};
 
-    std::map<char, std::string_view> short_names_to_long_;
-    std::map<std::string, size_t> arguments_indeces_;
+    // The generation of the argument in each slot, see ArgHandle
+    std::pmr::vector<uint64_t> generations_{&schema_memory_};
+    static uint64_t GetNextGeneration();
 
-    std::map<std::string_view, std::string> help_description_types_;
+    std::pmr::map<char, std::string_view> short_names_to_long_{&schema_memory_};
+    std::pmr::map<std::pmr::string, size_t, std::less<>> arguments_indeces_{&schema_memory_};
+
+    std::pmr::map<std::string_view, std::pmr::string> help_description_types_{&schema_memory_};
 
     ParsingError error_;
 
     bool need_help_ = false;
-    std::string help_argument_name_;
+    std::pmr::string help_argument_name_{&schema_memory_};
+
+    bool allow_abbreviations_ = false;
+    bool validate_utf8_ = false;
+    bool use_defined_options_ = false;
+
+    int positional_fd_ = -1;
+    char positional_delimiter_ = '\0';
+
+    ParseObserver* observer_ = nullptr;
+
+    FlagStore flags_{&schema_memory_};
+
+    std::pmr::vector<Constraint> constraints_{&schema_memory_};
+    ArgumentMask present_arguments_{&schema_memory_};
+    bool are_constraints_valid_ = false;
+
+    mutable bool is_names_index_valid_ = false;
+    mutable std::pmr::vector<std::string_view> sorted_long_names_{&schema_memory_};
+    mutable std::pmr::vector<std::string_view> long_names_by_length_{&schema_memory_};
 
     void RefreshParser();
+    void AddDefinedOptions();
+
+    // Buffers reused between the parses, so that a repeated parse doesn't allocate
+    std::pmr::vector<std::string_view> argv_{&parse_memory_};
+    std::pmr::vector<size_t> unused_positions_{&parse_memory_};
+    std::pmr::vector<std::string_view> long_names_{&parse_memory_};
+    std::pmr::vector<size_t> positional_args_indeces_{&parse_memory_};
+
+    // A copy of the streamed token which failed, the reader's buffers are reused
+    std::pmr::string stream_error_token_{&parse_memory_};
+
+    PathCheckBatch path_checks_{&parse_memory_};
+    GlobExpander glob_expander_;
 
-    std::vector<std::string_view> GetLongNames(std::string_view argument) const;
+    void GetLongNames(std::string_view argument, std::pmr::vector<std::string_view>& names) const;
 
-    void ParsePositionalArguments(const std::vector<std::string_view>& argv,
-                                  const std::vector<size_t>& positions);
+    void BuildNamesIndex() const;
+    std::span<const std::string_view> GetAbbreviationCandidates(std::string_view prefix) const;
+
+    void ParsePositionalArguments(std::span<const std::string_view> argv,
+                                  std::span<const size_t> positions);
+
+    std::expected<size_t, ParsingError> ParsePositionalValue(Argument* argument,
+                                                             std::span<const std::string_view> argv,
+                                                             size_t position);
+
+    void ParsePositionalStream(int fd, char delimiter);
+
+    bool ValidateArgvUtf8(std::span<const std::string_view> argv);
 
     bool HandleErrors();
+    bool CheckPaths();
+
+    bool BuildConstraints();
+    bool CheckConstraints();
 
     std::string GetArgumentDescription(const Argument* argument,
                                        size_t max_argument_names_length) const;
 
     std::string GetArgumentNamesDescription(const Argument* argument) const;
+
+    // nullptr if there is no argument with the name or it has another type
+    template<typename T>
+    SpecificArgument<T>* FindArgument(std::string_view long_name) const;
+
+    template<typename T>
+    const SpecificArgument<T>* FindArgument(ArgHandle<T> handle) const;
 };
 
 template<typename T>
 SpecificArgument<T>& ArgParser::AddArgument(char short_name,
                                             const std::string& long_name,
                                             const std::string& description) {
-    auto* argument = new SpecificArgument<T>(short_name, long_name, description);
+    auto* argument = std::pmr::polymorphic_allocator<>(&schema_memory_).new_object<SpecificArgument<T>>(
+        short_name, long_name, description, &schema_memory_, &parse_memory_);
+    argument->SetObserver(observer_);
+    is_names_index_valid_ = false;
+    are_constraints_valid_ = false;
+
+    if constexpr (std::is_same_v<T, bool>) {
+        argument->SetFlagStore(&flags_, flags_.Allocate());
+    }
 
-    if (arguments_indeces_.contains(long_name)) {
-        char arg_short_name = arguments_[arguments_indeces_.at(long_name)]->GetShortName();
+    auto index_it = arguments_indeces_.find(std::string_view(long_name));
+
+    if (index_it != arguments_indeces_.end()) {
+        char arg_short_name = arguments_[index_it->second]->GetShortName();
         short_names_to_long_.erase(arg_short_name);
-        short_names_to_long_[short_name] = long_name;
+        short_names_to_long_[short_name] = argument->GetLongName();
 
-        delete arguments_[arguments_indeces_.at(long_name)];
-        arguments_[arguments_indeces_.at(long_name)] = argument;
+        arguments_[index_it->second]->Destroy(&schema_memory_);
+        arguments_[index_it->second] = argument;
+        generations_[index_it->second] = GetNextGeneration();
+        argument->SetIndex(index_it->second, generations_[index_it->second]);
 
         return *argument;
     }
 
-    arguments_indeces_[long_name] = arguments_.size();
+    generations_.push_back(GetNextGeneration());
+    argument->SetIndex(arguments_.size(), generations_.back());
+    arguments_indeces_.emplace(std::string_view(long_name), arguments_.size());
     arguments_.push_back(argument);
-    short_names_to_long_[short_name] = long_name;
+    short_names_to_long_[short_name] = argument->GetLongName();
 
     return *argument;
 }
@@ -148,16 +332,112 @@ SpecificArgument<T>& ArgParser::AddArgument(const std::string& long_name,
 
 template <typename T>
 std::optional<T> ArgParser::GetValue(const std::string& long_name, size_t index) const {
-    if (!arguments_indeces_.contains(long_name)) {
+    const SpecificArgument<T>* argument = FindArgument<T>(long_name);
+
+    if (argument == nullptr) {
         return std::nullopt;
     }
 
-    size_t argument_index = arguments_indeces_.at(long_name);
-    auto* argument = static_cast<SpecificArgument<T>*>(arguments_.at(argument_index));
+    return argument->GetValue(index);
+}
+
+template<typename Config>
+StructBinder<Config> ArgParser::BindStruct(Config& config) {
+    return StructBinder<Config>(*this, config);
+}
+
+template<typename Config>
+template<typename T>
+SpecificArgument<T>& StructBinder<Config>::Bind(T Config::* field,
+                                                const std::string& long_name,
+                                                char short_name,
+                                                const std::string& description) {
+    return parser_.AddArgument<T>(short_name, long_name, description).Bind(config_.*field);
+}
+
+template<typename Config>
+template<typename T>
+SpecificArgument<T>& StructBinder<Config>::Bind(std::vector<T> Config::* field,
+                                                const std::string& long_name,
+                                                char short_name,
+                                                const std::string& description) {
+    // Like the other fields, the vector is optional
+    return parser_.AddArgument<T>(short_name, long_name, description)
+        .MultiValue()
+        .Default(T{})
+        .StoreValues(config_.*field);
+}
+
+template<typename T>
+std::span<const T> ArgParser::GetValues(const std::string& long_name) const requires (!std::is_same_v<T, bool>) {
+    const SpecificArgument<T>* argument = FindArgument<T>(long_name);
+
+    if (argument == nullptr) {
+        return {};
+    }
+
+    return argument->GetValues();
+}
+
+template<typename T>
+std::vector<T> ArgParser::TakeValues(const std::string& long_name) requires (!std::is_same_v<T, bool>) {
+    SpecificArgument<T>* argument = FindArgument<T>(long_name);
+
+    if (argument == nullptr) {
+        return {};
+    }
+
+    return argument->TakeValues();
+}
+
+template<typename T>
+SpecificArgument<T>* ArgParser::FindArgument(std::string_view long_name) const {
+    auto index_it = arguments_indeces_.find(long_name);
+
+    if (index_it == arguments_indeces_.end()) {
+        return nullptr;
+    }
+
+    // An argument of another type has no value of type T
+    return dynamic_cast<SpecificArgument<T>*>(arguments_[index_it->second]);
+}
+
+template<typename T>
+const SpecificArgument<T>* ArgParser::FindArgument(ArgHandle<T> handle) const {
+    if (handle.GetIndex() >= arguments_.size()) {
+        return nullptr;
+    }
+
+    // The generations are unique across the parsers, so the type of the argument is the handle's one
+    if (generations_[handle.GetIndex()] != handle.generation_) {
+        return nullptr;
+    }
+
+    return static_cast<const SpecificArgument<T>*>(arguments_[handle.GetIndex()]);
+}
+
+template<typename T>
+std::optional<T> ArgParser::GetValue(ArgHandle<T> handle, size_t index) const {
+    const SpecificArgument<T>* argument = FindArgument(handle);
+
+    if (argument == nullptr) {
+        return std::nullopt;
+    }
 
     return argument->GetValue(index);
 }
 
+template<typename T>
+std::span<const T> ArgParser::Values(ArgHandle<T> handle) const requires (!std::is_same_v<T, bool>) {
+    const SpecificArgument<T>* argument = FindArgument(handle);
+
+    if (argument == nullptr) {
+        return {};
+    }
+
+    return argument->GetValues();
+}
+
 template <typename T>
 void ArgParser::SetTypeAlias(const std::string& alias) {
     help_description_types_[typeid(T).name()] = alias;
@@ -167,3 +447,7 @@ void ArgParser::SetTypeAlias(const std::string& alias) {
 
 #undef ARGPARSER_ADD_ARGUMENT
 #undef ARGPARSER_GET_VALUE
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "ArgParser.cpp"
+#endif
@@ -1,15 +1,23 @@
 #pragma once
 
+#include "ParseObserver.hpp"
+
 #include <string>
 #include <string_view>
 #include <cstddef>
+#include <memory_resource>
 #include <vector>
+#include <span>
 #include <expected>
 
 namespace ArgumentParser {
 
 const char kNoShortName = -1;
 
+class GlobExpander;
+class PathCheckBatch;
+struct UserCredentials;
+
 enum class ArgumentStatus {
     kSuccess,
     kNoArgument,
@@ -22,6 +30,16 @@ enum class ParsingErrorType {
     kInvalidArgument,
     kUnknownArgument,
     kNoArgument,
+    kAmbiguousArgument,
+    kOutOfRange,
+    kExclusiveArguments,
+    kMissingGroupArgument,
+    kMissingDependency,
+    kInvalidPath,
+    kNoGlobMatch,
+    kUnknownConstraintArgument,
+    kStreamReadError,
+    kNoStreamArgument,
     kSuccess
 };
 
@@ -29,31 +47,60 @@ struct ParsingError {
     std::string_view argument_string;
     ParsingErrorType status = ParsingErrorType::kSuccess;
     std::string_view argument_name;
+    std::span<const std::string_view> candidates;
+    // errno of a failed read of the positional stream
+    int error_number = 0;
 };
 
 class Argument {
 public:
+    virtual ~Argument() = default;
+
     virtual std::string_view GetType() const = 0;
+
+    // The number of tokens of a value, and the type of each of them. It's more than 1 for tuples
+    virtual size_t GetArity() const = 0;
+    virtual std::string_view GetElementType() const = 0;
     virtual ArgumentStatus GetValueStatus() const = 0;
     virtual size_t GetValuesSet() const = 0;
-    virtual const std::string& GetDefaultValueString() const = 0;
+    virtual std::string_view GetDefaultValueString() const = 0;
     virtual void SetDefaultValueString(const std::string& str) = 0;
 
-    virtual const std::string& GetDescription() const = 0;
-    virtual const std::string& GetLongName() const = 0;
+    virtual std::string_view GetDescription() const = 0;
+    virtual std::string_view GetLongName() const = 0;
     virtual char GetShortName() const = 0;
 
     virtual bool IsPositional() const = 0;
     virtual bool IsMultiValue() const = 0;
     virtual bool HasDefault() const = 0;
     virtual size_t GetMinimumValues() const = 0;
+    virtual std::span<const std::string_view> GetChoices() const = 0;
 
     virtual bool IsFlag() const = 0;
 
-    virtual std::expected<size_t, ParsingError> ParseArgument(const std::vector<std::string_view>& argv,
+    virtual std::expected<size_t, ParsingError> ParseArgument(std::span<const std::string_view> argv,
                                                               size_t position) = 0;
 
+    // Positional glob arguments take all the paths matching the pattern as their values
+    virtual bool IsGlob() const = 0;
+    virtual std::expected<size_t, ParsingError> ParseGlob(std::string_view pattern, GlobExpander& expander) = 0;
+
     virtual void Clear() = 0;
+
+    // Path arguments add their values to the batch of checks, and take the results after the batch is run
+    virtual void AddPathChecks(PathCheckBatch& batch) = 0;
+    virtual std::expected<void, ParsingError> TakePathChecks(const PathCheckBatch& batch,
+                                                             const UserCredentials& credentials) = 0;
+
+    virtual void SetObserver(ParseObserver* observer) = 0;
+
+    virtual size_t GetValuesMemoryUsage() const = 0;
+
+    // Whether the other argument has the same type and the same values
+    virtual bool HasSameValues(const Argument& other) const = 0;
+
+    // Destroys the argument and returns its memory to the resource it was allocated from
+    virtual void Destroy(std::pmr::memory_resource* memory) = 0;
 };
 
 } // namespace ArgumentParser
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser {
+
+// A fixed set of named values.
+// The names are placed into a table by a perfect hash found once the set is defined,
+// so a lookup costs one hash and one comparison.
+template<typename T>
+class ChoiceTable {
+public:
+    ChoiceTable(std::initializer_list<std::pair<std::string_view, T>> choices,
+                std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // The names are referenced by views, so the table never moves
+    ChoiceTable(const ChoiceTable&) = delete;
+    ChoiceTable& operator=(const ChoiceTable&) = delete;
+
+    std::optional<T> Find(std::string_view name) const;
+    std::optional<std::string_view> GetName(const T& value) const;
+    std::span<const std::string_view> GetNames() const;
+
+private:
+    static constexpr uint32_t kEmptySlot = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t kSeedsPerTableSize = 64;
+
+    std::pmr::vector<std::pmr::string> names_storage_;
+    std::pmr::vector<std::string_view> names_;
+    std::pmr::vector<T> values_;
+
+    std::pmr::vector<uint32_t> slots_;
+    uint64_t seed_ = 0;
+    uint64_t mask_ = 0;
+
+    static uint64_t Hash(std::string_view name, uint64_t seed);
+    bool TryBuildSlots(uint64_t seed, size_t table_size);
+};
+
+template<typename T>
+ChoiceTable<T>::ChoiceTable(std::initializer_list<std::pair<std::string_view, T>> choices,
+                            std::pmr::memory_resource* memory)
+    : names_storage_(memory),
+      names_(memory),
+      values_(memory),
+      slots_(memory) {
+    names_storage_.reserve(choices.size());
+    values_.reserve(choices.size());
+
+    for (const auto& [name, value] : choices) {
+        names_storage_.emplace_back(name);
+        values_.push_back(value);
+    }
+
+    names_.assign(names_storage_.begin(), names_storage_.end());
+
+    size_t table_size = 1;
+    while (table_size < names_.size()) {
+        table_size <<= 1;
+    }
+
+    for (;; table_size <<= 1) {
+        for (uint64_t seed = 0; seed < kSeedsPerTableSize; ++seed) {
+            if (TryBuildSlots(seed, table_size)) {
+                return;
+            }
+        }
+    }
+}
+
+template<typename T>
+bool ChoiceTable<T>::TryBuildSlots(uint64_t seed, size_t table_size) {
+    slots_.assign(table_size, kEmptySlot);
+    seed_ = seed;
+    mask_ = table_size - 1;
+
+    for (uint32_t i = 0; i < names_.size(); ++i) {
+        uint32_t& slot = slots_[Hash(names_[i], seed_) & mask_];
+
+        // Equal names are allowed, the first one wins
+        if (slot != kEmptySlot && names_[slot] != names_[i]) {
+            return false;
+        }
+
+        if (slot == kEmptySlot) {
+            slot = i;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+uint64_t ChoiceTable<T>::Hash(std::string_view name, uint64_t seed) {
+    // FNV-1a with the seed mixed into the offset basis and a final avalanche
+    uint64_t hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+
+    for (const char symbol : name) {
+        hash ^= static_cast<unsigned char>(symbol);
+        hash *= 1099511628211ULL;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+template<typename T>
+std::optional<T> ChoiceTable<T>::Find(std::string_view name) const {
+    uint32_t slot = slots_[Hash(name, seed_) & mask_];
+
+    if (slot == kEmptySlot || names_[slot] != name) {
+        return std::nullopt;
+    }
+
+    return values_[slot];
+}
+
+template<typename T>
+std::optional<std::string_view> ChoiceTable<T>::GetName(const T& value) const {
+    for (size_t i = 0; i < values_.size(); ++i) {
+        if (values_[i] == value) {
+            return names_[i];
+        }
+    }
+
+    return std::nullopt;
+}
+
+template<typename T>
+std::span<const std::string_view> ChoiceTable<T>::GetNames() const {
+    return names_;
+}
+
+} // namespace ArgumentParser
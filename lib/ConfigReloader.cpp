@@ -0,0 +1,193 @@
+#include "ConfigReloader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+
+#if __has_include(<sys/inotify.h>)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define ARGPARSER_HAS_INOTIFY
+#endif
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE bool ConfigSnapshot::IsChanged(std::string_view long_name) const {
+    return std::find(changed_arguments_.begin(), changed_arguments_.end(), long_name) != changed_arguments_.end();
+}
+
+ARGPARSER_INLINE ConfigReloader::ConfigReloader(std::string path, SchemaBuilder build_schema)
+    : path_(std::move(path)),
+      build_schema_(std::move(build_schema)) {
+    Reload();
+}
+
+ARGPARSER_INLINE ConfigReloader::~ConfigReloader() {
+    StopWatching();
+}
+
+ARGPARSER_INLINE bool ConfigReloader::Reload() {
+    std::unique_lock lock(reload_mutex_);
+
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    snapshot->tokens_.emplace_back(path_);
+
+    std::ifstream file(path_);
+    int open_error_number = file.is_open() ? 0 : errno;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (!line.empty() && line[0] != '#') {
+            snapshot->tokens_.push_back(std::move(line));
+        }
+    }
+
+    if (!file.eof()) {
+        last_error_ = ParsingErrorType::kStreamReadError;
+        last_error_number_ = (open_error_number != 0) ? open_error_number : errno;
+        return false;
+    }
+
+    snapshot->parser_ = std::make_unique<ArgParser>(path_);
+    build_schema_(*snapshot->parser_);
+
+    if (!snapshot->parser_->Parse(snapshot->tokens_)) {
+        last_error_ = snapshot->parser_->GetError().status;
+        last_error_number_ = 0;
+        return false;
+    }
+
+    std::shared_ptr<const ConfigSnapshot> previous = snapshot_.load(std::memory_order_acquire);
+
+    if (previous != nullptr) {
+        snapshot->changed_arguments_ = snapshot->parser_->GetChangedArguments(*previous->parser_);
+        snapshot->version_ = previous->version_ + 1;
+    } else {
+        // Everything is new in the first snapshot
+        snapshot->changed_arguments_ = snapshot->parser_->GetChangedArguments(ArgParser(path_));
+    }
+
+    // The readers share the parser, so nothing may be built lazily after it's published
+    snapshot->parser_->BuildCaches();
+
+    last_error_ = ParsingErrorType::kSuccess;
+    last_error_number_ = 0;
+    snapshot_.store(snapshot, std::memory_order_release);
+
+    // The callback may call back into the reloader, so it's called without the lock
+    ReloadCallback on_reload = on_reload_;
+    lock.unlock();
+
+    if (on_reload) {
+        on_reload(*snapshot);
+    }
+
+    return true;
+}
+
+ARGPARSER_INLINE ParsingErrorType ConfigReloader::GetLastError() const {
+    std::lock_guard lock(reload_mutex_);
+    return last_error_;
+}
+
+ARGPARSER_INLINE int ConfigReloader::GetLastErrorNumber() const {
+    std::lock_guard lock(reload_mutex_);
+    return last_error_number_;
+}
+
+ARGPARSER_INLINE void ConfigReloader::SetReloadCallback(ReloadCallback callback) {
+    std::lock_guard lock(reload_mutex_);
+    on_reload_ = std::move(callback);
+}
+
+ARGPARSER_INLINE bool ConfigReloader::StartWatching() {
+#ifdef ARGPARSER_HAS_INOTIFY
+    if (watcher_.joinable()) {
+        return true;
+    }
+
+    // The directory is watched, because editors often replace the file instead of writing it
+    std::filesystem::path directory = std::filesystem::path(path_).parent_path();
+
+    if (directory.empty()) {
+        directory = ".";
+    }
+
+    inotify_fd_ = inotify_init1(IN_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+
+    if (inotify_fd_ < 0 || stop_fd_ < 0
+        || inotify_add_watch(inotify_fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+        StopWatching();
+        return false;
+    }
+
+    watcher_ = std::thread(&ConfigReloader::Watch, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+ARGPARSER_INLINE void ConfigReloader::StopWatching() {
+#ifdef ARGPARSER_HAS_INOTIFY
+    if (watcher_.joinable()) {
+        uint64_t value = 1;
+        [[maybe_unused]] ssize_t written = write(stop_fd_, &value, sizeof(value));
+        watcher_.join();
+    }
+
+    for (int* fd : {&inotify_fd_, &stop_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+#endif
+}
+
+ARGPARSER_INLINE void ConfigReloader::Watch() {
+#ifdef ARGPARSER_HAS_INOTIFY
+    std::string file_name = std::filesystem::path(path_).filename().string();
+    alignas(inotify_event) std::array<char, 4096> buffer;
+
+    while (true) {
+        std::array<pollfd, 2> fds = {{{inotify_fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}}};
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            continue;
+        }
+
+        if (fds[1].revents != 0) {
+            return;
+        }
+
+        ssize_t length = read(inotify_fd_, buffer.data(), buffer.size());
+        bool is_changed = false;
+
+        for (ssize_t offset = 0; offset < length;) {
+            auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+
+            if (event->len > 0 && file_name == event->name) {
+                is_changed = true;
+            }
+
+            offset += sizeof(inotify_event) + event->len;
+        }
+
+        if (is_changed) {
+            Reload();
+        }
+    }
+#endif
+}
+
+} // namespace ArgumentParser
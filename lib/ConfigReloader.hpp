@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ArgParser.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace ArgumentParser {
+
+// The immutable result of a single parse of the configuration.
+// Any number of threads may read it, it's never changed after it's published.
+// The caches of the parser are filled before publishing, so its const methods are safe to call concurrently.
+class ConfigSnapshot {
+public:
+    const ArgParser& GetParser() const {
+        return *parser_;
+    }
+
+    template<typename T>
+    std::optional<T> GetValue(const std::string& long_name, size_t index = 0) const {
+        return parser_->GetValue<T>(long_name, index);
+    }
+
+    // The arguments whose values differ from the previous snapshot
+    std::span<const std::string_view> GetChangedArguments() const {
+        return changed_arguments_;
+    }
+
+    bool IsChanged(std::string_view long_name) const;
+
+    uint64_t GetVersion() const {
+        return version_;
+    }
+
+private:
+    std::vector<std::string> tokens_;
+    std::unique_ptr<ArgParser> parser_;
+    std::vector<std::string_view> changed_arguments_;
+    uint64_t version_ = 0;
+
+    friend class ConfigReloader;
+};
+
+// Options read from a file: one argument per line, e.g. "--threads=8".
+// Empty lines and lines starting with '#' are skipped.
+// Every reload parses the file with a new parser and publishes a new snapshot atomically,
+// so the readers never wait for a reload and never see a partially parsed configuration.
+class ConfigReloader {
+public:
+    using SchemaBuilder = std::function<void(ArgParser& parser)>;
+    using ReloadCallback = std::function<void(const ConfigSnapshot& snapshot)>;
+
+    // The file is parsed for the first time in the constructor
+    ConfigReloader(std::string path, SchemaBuilder build_schema);
+    ~ConfigReloader();
+
+    ConfigReloader(const ConfigReloader&) = delete;
+    ConfigReloader& operator=(const ConfigReloader&) = delete;
+
+    // nullptr until the file is parsed successfully
+    std::shared_ptr<const ConfigSnapshot> GetSnapshot() const {
+        return snapshot_.load(std::memory_order_acquire);
+    }
+
+    // Re-parses the file, e.g. on SIGHUP. If the parsing fails, the previous snapshot is kept
+    bool Reload();
+
+    // The error of the last failed reload
+    ParsingErrorType GetLastError() const;
+
+    // The errno of the last reload which failed with kStreamReadError, e.g. ENOENT
+    int GetLastErrorNumber() const;
+
+    // Called after a new snapshot is published, from the thread which reloaded the file.
+    // It runs without the reload lock, so it may call the reloader
+    void SetReloadCallback(ReloadCallback callback);
+
+    // Reloads the file whenever it's changed, using inotify in a background thread.
+    // Returns false if the file can't be watched
+    bool StartWatching();
+    void StopWatching();
+
+private:
+    std::string path_;
+    SchemaBuilder build_schema_;
+    ReloadCallback on_reload_;
+
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> snapshot_;
+    ParsingErrorType last_error_ = ParsingErrorType::kSuccess;
+    int last_error_number_ = 0;
+
+    // Reloads are serialized, the readers don't take it
+    mutable std::mutex reload_mutex_;
+
+    std::thread watcher_;
+    int inotify_fd_ = -1;
+    int stop_fd_ = -1;
+
+    void Watch();
+};
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "ConfigReloader.cpp"
+#endif
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// A set of arguments of a parser, one bit per argument index
+class ArgumentMask {
+public:
+    explicit ArgumentMask(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : words_(memory) {}
+
+    void Resize(size_t size) {
+        words_.assign((size + kWordBits - 1) / kWordBits, 0);
+    }
+
+    void Set(size_t index) {
+        words_[index / kWordBits] |= uint64_t{1} << (index % kWordBits);
+    }
+
+    void Clear() {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    bool Test(size_t index) const {
+        return (words_[index / kWordBits] >> (index % kWordBits)) & 1;
+    }
+
+    // The number of arguments in both sets. Both masks must have the same size
+    size_t CountCommon(const ArgumentMask& other) const {
+        size_t count = 0;
+
+        for (size_t i = 0; i < words_.size(); ++i) {
+            count += std::popcount(words_[i] & other.words_[i]);
+        }
+
+        return count;
+    }
+
+    bool Contains(const ArgumentMask& other) const {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            if ((words_[i] & other.words_[i]) != other.words_[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr size_t kWordBits = 64;
+
+    std::pmr::vector<uint64_t> words_;
+};
+
+// A rule over the presence of arguments. The names are compiled into a mask
+// when the parser is used for the first time after its arguments were changed.
+struct Constraint {
+    enum class Kind {
+        // At most one argument of the group may be set (exactly one, if required)
+        kExclusiveGroup,
+        // If the dependent argument is set, all the other arguments must be set too
+        kDependency
+    };
+
+    Constraint(Kind kind,
+               std::string_view dependent_name,
+               std::initializer_list<std::string_view> names,
+               bool is_required,
+               std::pmr::memory_resource* memory)
+        : kind(kind),
+          dependent_name(dependent_name, memory),
+          names_storage(memory),
+          names(memory),
+          is_required(is_required),
+          mask(memory) {
+        names_storage.reserve(names.size());
+
+        for (std::string_view name : names) {
+            names_storage.emplace_back(name);
+        }
+    }
+
+    Kind kind;
+    std::pmr::string dependent_name;
+    std::pmr::vector<std::pmr::string> names_storage;
+
+    // Views of names_storage, they are set when the constraint is compiled
+    std::pmr::vector<std::string_view> names;
+    bool is_required = false;
+
+    ArgumentMask mask;
+    size_t dependent_index = kNoIndex;
+
+    static constexpr size_t kNoIndex = static_cast<size_t>(-1);
+};
+
+} // namespace ArgumentParser
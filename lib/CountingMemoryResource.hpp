@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+
+namespace ArgumentParser {
+
+// Passes the allocations to the upstream resource and counts the bytes currently allocated
+class CountingMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream) {}
+
+    CountingMemoryResource(const CountingMemoryResource&) = delete;
+    CountingMemoryResource& operator=(const CountingMemoryResource&) = delete;
+
+    size_t GetBytes() const {
+        return bytes_;
+    }
+
+    size_t GetPeakBytes() const {
+        return peak_bytes_;
+    }
+
+    void ResetPeak() {
+        peak_bytes_ = bytes_;
+    }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    size_t bytes_ = 0;
+    size_t peak_bytes_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* pointer = upstream_->allocate(bytes, alignment);
+        bytes_ += bytes;
+        peak_bytes_ = std::max(peak_bytes_, bytes_);
+
+        return pointer;
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        upstream_->deallocate(pointer, bytes, alignment);
+        bytes_ -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace ArgumentParser
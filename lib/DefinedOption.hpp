@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ArgParser.hpp"
+#include "OptionRegistry.hpp"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ArgumentParser {
+
+// The value of an option defined by ARGPARSER_DEFINE_OPTION. It holds the default value
+// until the parser which uses the defined options is parsed, and then the parsed value.
+template<typename T>
+class Option : public OptionNode {
+public:
+    // A string option takes its default as a literal, so that the option stays constant-initialized
+    using DefaultType = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, T>;
+
+    constexpr Option(std::string_view long_name, DefaultType default_value, std::string_view description)
+        : OptionNode{long_name, description, &AddToParser},
+          default_value_(default_value) {
+        // A std::string may allocate, so it gets the default value when it's added to the parser
+        if constexpr (!std::is_same_v<T, std::string>) {
+            value_ = default_value;
+        }
+    }
+
+    Option(const Option&) = delete;
+    Option& operator=(const Option&) = delete;
+
+    const T& Get() const {
+        return value_;
+    }
+
+    const T& operator*() const {
+        return value_;
+    }
+
+    const T* operator->() const {
+        return &value_;
+    }
+
+private:
+    DefaultType default_value_;
+    T value_{};
+
+    static void AddToParser(ArgParser& parser, OptionNode& node) {
+        Option& option = static_cast<Option&>(node);
+        option.value_ = T(option.default_value_);
+
+        parser.AddArgument<T>(std::string(option.long_name), std::string(option.description)).Bind(option.value_);
+    }
+};
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_OPTION_SECTIONS
+#define ARGPARSER_REGISTER_OPTION(name) \
+    [[gnu::used, gnu::section("argparser_options")]] \
+    static ::ArgumentParser::OptionNode* const argparser_option_node_##name = &option_##name;
+#else
+#define ARGPARSER_REGISTER_OPTION(name) \
+    static const ::ArgumentParser::OptionRegistrar argparser_option_registrar_##name(option_##name);
+#endif
+
+// Defines the option "--name" next to the code which uses it, gflags-style. The value is read as *option_name.
+// The option must be defined at namespace scope, once in the program.
+#define ARGPARSER_DEFINE_OPTION(Type, name, default_value, description) \
+    constinit ::ArgumentParser::Option<Type> option_##name(#name, default_value, description); \
+    ARGPARSER_REGISTER_OPTION(name)
+
+// Makes an option defined in another translation unit available
+#define ARGPARSER_DECLARE_OPTION(Type, name) \
+    extern ::ArgumentParser::Option<Type> option_##name
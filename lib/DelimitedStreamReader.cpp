@@ -0,0 +1,145 @@
+#include "DelimitedStreamReader.hpp"
+#include "utils/utils.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE DelimitedStreamReader::DelimitedStreamReader(int fd, char delimiter, size_t block_size)
+    : fd_(fd),
+      delimiter_(delimiter),
+      block_size_(block_size) {
+    for (Block& block : blocks_) {
+        block.data = std::make_unique_for_overwrite<char[]>(block_size);
+    }
+
+    if (pipe(stop_pipe_) != 0) {
+        stop_pipe_[0] = stop_pipe_[1] = -1;
+    }
+
+    reader_ = std::thread(&DelimitedStreamReader::ReadBlocks, this);
+}
+
+ARGPARSER_INLINE DelimitedStreamReader::~DelimitedStreamReader() {
+    Stop();
+    reader_.join();
+
+    for (int fd : stop_pipe_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+ARGPARSER_INLINE void DelimitedStreamReader::Stop() {
+    {
+        std::lock_guard lock(mutex_);
+
+        if (is_stopped_) {
+            return;
+        }
+
+        is_stopped_ = true;
+    }
+
+    block_changed_.notify_all();
+
+    if (stop_pipe_[1] >= 0) {
+        char byte = 0;
+        [[maybe_unused]] ssize_t written = write(stop_pipe_[1], &byte, 1);
+    }
+}
+
+ARGPARSER_INLINE void DelimitedStreamReader::ReadBlocks() {
+    for (size_t index = 0;; index ^= 1) {
+        Block& block = blocks_[index];
+
+        {
+            std::unique_lock lock(mutex_);
+            block_changed_.wait(lock, [this, &block] { return !block.is_filled || is_stopped_; });
+
+            if (is_stopped_) {
+                return;
+            }
+        }
+
+        // The block belongs to this thread until it's marked as filled
+        bool is_last = !FillBlock(block);
+
+        {
+            std::lock_guard lock(mutex_);
+            block.is_last = is_last;
+            block.is_filled = true;
+        }
+
+        block_changed_.notify_all();
+
+        if (is_last) {
+            return;
+        }
+    }
+}
+
+ARGPARSER_INLINE bool DelimitedStreamReader::FillBlock(Block& block) {
+    block.size = 0;
+
+    while (block.size < block_size_) {
+        if (stop_pipe_[0] >= 0) {
+            pollfd fds[2] = {{fd_, POLLIN, 0}, {stop_pipe_[0], POLLIN, 0}};
+
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                read_error_ = errno;
+                return false;
+            }
+
+            if (fds[1].revents != 0) {
+                return false;
+            }
+        }
+
+        ssize_t length = read(fd_, block.data.get() + block.size, block_size_ - block.size);
+
+        if (length == 0) {
+            return false;
+        }
+
+        if (length < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+
+            read_error_ = errno;
+            return false;
+        }
+
+        block.size += static_cast<size_t>(length);
+    }
+
+    return true;
+}
+
+ARGPARSER_INLINE const DelimitedStreamReader::Block& DelimitedStreamReader::AcquireBlock(size_t index) {
+    std::unique_lock lock(mutex_);
+    block_changed_.wait(lock, [this, index] { return blocks_[index].is_filled; });
+
+    return blocks_[index];
+}
+
+ARGPARSER_INLINE void DelimitedStreamReader::ReleaseBlock(size_t index) {
+    {
+        std::lock_guard lock(mutex_);
+        blocks_[index].is_filled = false;
+    }
+
+    block_changed_.notify_all();
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace ArgumentParser {
+
+// Splits the data of a file descriptor into tokens by a delimiter ('\0' for `find -print0`, '\n' for lines).
+// A background thread reads the next block while the current one is split and processed,
+// and the two blocks are reused, so the memory doesn't depend on the size of the stream.
+class DelimitedStreamReader {
+public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+    DelimitedStreamReader(int fd, char delimiter, size_t block_size = kDefaultBlockSize);
+    ~DelimitedStreamReader();
+
+    DelimitedStreamReader(const DelimitedStreamReader&) = delete;
+    DelimitedStreamReader& operator=(const DelimitedStreamReader&) = delete;
+
+    // Calls on_token(std::string_view) for every non-empty token. The view is valid only during the call.
+    // Reading stops when on_token returns false, and then ForEachToken returns false too
+    template<typename OnToken>
+    bool ForEachToken(OnToken on_token);
+
+    // errno of a failed read, or 0
+    int GetReadError() const {
+        return read_error_;
+    }
+
+private:
+    struct Block {
+        // Not initialized, the reads overwrite it
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+        bool is_filled = false;
+        bool is_last = false;
+    };
+
+    int fd_;
+    char delimiter_;
+    size_t block_size_;
+
+    std::array<Block, 2> blocks_;
+    std::mutex mutex_;
+    std::condition_variable block_changed_;
+    bool is_stopped_ = false;
+    int read_error_ = 0;
+
+    // Wakes up the reader blocked in poll() when the reading is stopped early
+    int stop_pipe_[2] = {-1, -1};
+
+    // The beginning of a token which continues in the next block
+    std::string carry_;
+
+    std::thread reader_;
+
+    void ReadBlocks();
+    bool FillBlock(Block& block);
+
+    const Block& AcquireBlock(size_t index);
+    void ReleaseBlock(size_t index);
+    void Stop();
+};
+
+template<typename OnToken>
+bool DelimitedStreamReader::ForEachToken(OnToken on_token) {
+    for (size_t index = 0;; index ^= 1) {
+        const Block& block = AcquireBlock(index);
+        std::string_view data(block.data.get(), block.size);
+        size_t start = 0;
+
+        for (size_t end = data.find(delimiter_); end != std::string_view::npos; end = data.find(delimiter_, start)) {
+            std::string_view token = data.substr(start, end - start);
+            start = end + 1;
+
+            if (!carry_.empty()) {
+                carry_ += token;
+                token = carry_;
+            }
+
+            if (!token.empty() && !on_token(token)) {
+                Stop();
+                return false;
+            }
+
+            carry_.clear();
+        }
+
+        carry_ += data.substr(start);
+
+        bool is_last = block.is_last;
+        ReleaseBlock(index);
+
+        if (is_last) {
+            break;
+        }
+    }
+
+    if (!carry_.empty() && !on_token(std::string_view(carry_))) {
+        return false;
+    }
+
+    carry_.clear();
+
+    return read_error_ == 0;
+}
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "DelimitedStreamReader.cpp"
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace ArgumentParser {
+
+// The values of all flags of a parser, one bit per flag
+class FlagStore {
+public:
+    explicit FlagStore(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : words_(memory) {}
+
+    size_t Allocate() {
+        if (size_ % kWordBits == 0) {
+            words_.push_back(0);
+        }
+
+        return size_++;
+    }
+
+    void Set(size_t bit) {
+        words_[bit / kWordBits] |= uint64_t{1} << (bit % kWordBits);
+    }
+
+    bool Test(size_t bit) const {
+        return (words_[bit / kWordBits] >> (bit % kWordBits)) & 1;
+    }
+
+    void Clear() {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    static constexpr size_t kWordBits = 64;
+
+    std::pmr::vector<uint64_t> words_;
+    size_t size_ = 0;
+};
+
+// The place of a single flag in the FlagStore and, optionally, in a user's bitset
+struct FlagBinding {
+    FlagStore* store = nullptr;
+    size_t bit = 0;
+
+    void* target = nullptr;
+    size_t target_position = 0;
+    void (*assign_target)(void* target, size_t position, bool value) = nullptr;
+
+    template<size_t N>
+    void BindTarget(std::bitset<N>& to, size_t position) {
+        target = &to;
+        target_position = position;
+        assign_target = [](void* target, size_t position, bool value) {
+            static_cast<std::bitset<N>*>(target)->set(position, value);
+        };
+    }
+
+    void AssignTarget(bool value) const {
+        if (target != nullptr) {
+            assign_target(target, target_position, value);
+        }
+    }
+};
+
+} // namespace ArgumentParser
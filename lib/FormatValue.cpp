@@ -0,0 +1,15 @@
+#include "FormatValue.hpp"
+#include "utils/utils.hpp"
+
+#include <sstream>
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE std::string FormatWithStream(const void* value, void (*write)(std::ostream& stream, const void* value)) {
+    std::ostringstream stream;
+    write(stream, value);
+
+    return std::move(stream).str();
+}
+
+} // namespace ArgumentParser
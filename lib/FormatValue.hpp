@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TupleValue.hpp"
+
+#include <charconv>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ArgumentParser {
+
+template<typename T>
+concept StreamFormattable = requires(std::ostream& stream, const T& value) {
+    stream << value;
+};
+
+// Prints a value by the callback into a std::ostringstream. It's defined in FormatValue.cpp,
+// so that the headers don't include the streams
+std::string FormatWithStream(const void* value, void (*write)(std::ostream& stream, const void* value));
+
+// Converts the default value of an argument to a string for the help message.
+// It's called only when the help is rendered. Numbers are printed by std::to_chars
+// in the shortest form that reads back to the same value. Other types are printed by operator<< if they have one,
+// otherwise the value isn't shown. A formatter for a user type may be registered by a specialization, like ParseValue.
+template<typename T>
+std::string FormatValue(const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return value ? "true" : "false";
+    } else if constexpr (std::is_same_v<T, char>) {
+        return std::string(1, value);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        char buffer[64];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string(buffer, result.ptr);
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return std::string(std::string_view(value));
+    } else if constexpr (TupleValue<T>) {
+        // The elements are separated by spaces, like in the argv
+        T tuple = value;
+        std::string result;
+
+        for (size_t i = 0; i < TupleTraits<T>::kArity; ++i) {
+            if (i > 0) {
+                result += ' ';
+            }
+
+            result += FormatValue(TupleTraits<T>::Get(tuple, i));
+        }
+
+        return result;
+    } else if constexpr (StreamFormattable<T>) {
+        return FormatWithStream(&value, [](std::ostream& stream, const void* erased_value) {
+            stream << *static_cast<const T*>(erased_value);
+        });
+    } else {
+        return {};
+    }
+}
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "FormatValue.cpp"
+#endif
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "Argument.hpp"
+#include "ParseValue.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// The hash of the perfect hash tables emitted by argparser-gen.
+// The generator and the generated parsers must use the same function, so it lives here.
+constexpr uint32_t HashName(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+
+    for (char symbol : name) {
+        hash = (hash ^ static_cast<unsigned char>(symbol)) * 16777619u;
+    }
+
+    // The final mix of MurmurHash3, so that the low bits depend on all the symbols
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+// The description of an argument of a generated schema
+struct GeneratedArgument {
+    std::string_view long_name;
+    char short_name = kNoShortName;
+    bool is_flag = false;
+    bool is_positional = false;
+    bool is_multi_value = false;
+    bool has_default = false;
+    size_t minimum_values = 0;
+};
+
+template<typename T>
+bool AssignGeneratedValue(T& field, std::string_view value_string) {
+    std::optional<T> value = ParseValue<T>(value_string);
+
+    if (!value.has_value()) {
+        return false;
+    }
+
+    field = std::move(*value);
+    return true;
+}
+
+template<typename T>
+bool AppendGeneratedValue(std::vector<T>& field, std::string_view value_string) {
+    std::optional<T> value = ParseValue<T>(value_string);
+
+    if (!value.has_value()) {
+        return false;
+    }
+
+    field.push_back(std::move(*value));
+    return true;
+}
+
+/*
+    The parser of a schema compiled by argparser-gen. The generated Schema provides:
+        Options                  - a struct with a typed field for every argument
+        kArguments               - std::array<GeneratedArgument, N>
+        kPositionalArguments     - the indices of the positional arguments in the order of the schema
+        kHelpIndex               - the index of the help flag, or kNoGeneratedHelp
+        kHashSeeds, kHashSlots   - the tables of the perfect hash of the long names
+        kHelpDescription         - the help message rendered by the generator
+        FindShortName(char)      - a switch over the short names
+        SetValue(options, index, value_string) - a switch over the arguments, false if the value is invalid
+        FinishValues(options, values_set)      - fills the multi value arguments which got no value with their defaults
+    The argv is handled like by ArgParser.
+*/
+inline constexpr size_t kNoGeneratedHelp = static_cast<size_t>(-1);
+
+template<typename Schema>
+class GeneratedParser {
+public:
+    using Options = typename Schema::Options;
+
+    bool Parse(std::span<const std::string_view> argv);
+    bool Parse(std::span<const char* const> argv);
+    bool Parse(const std::vector<std::string>& argv);
+    bool Parse(int argc, char** argv);
+
+    const Options& GetOptions() const {
+        return options_;
+    }
+
+    Options& GetOptions() {
+        return options_;
+    }
+
+    // The number of values of the argument set by the last parse
+    std::optional<size_t> GetValuesSet(std::string_view long_name) const;
+
+    bool Help() const {
+        return need_help_;
+    }
+
+    static constexpr std::string_view HelpDescription() {
+        return Schema::kHelpDescription;
+    }
+
+    ParsingError GetError() const {
+        return error_;
+    }
+
+    bool HasError() const {
+        return error_.status != ParsingErrorType::kSuccess;
+    }
+
+    static std::optional<size_t> FindLongName(std::string_view long_name);
+
+private:
+    Options options_;
+    std::array<size_t, Schema::kArguments.size()> values_set_{};
+    ParsingError error_;
+    bool need_help_ = false;
+
+    // Buffers reused between the parses
+    std::vector<std::string_view> argv_;
+    std::vector<size_t> unused_positions_;
+
+    bool SetValue(size_t index, std::string_view value_string, std::string_view argument_string);
+    bool ParseLongOption(std::span<const std::string_view> argv, size_t& position);
+    bool ParseShortOptions(std::span<const std::string_view> argv, size_t& position);
+    bool ParsePositionalArguments(std::span<const std::string_view> argv);
+    bool HandleErrors();
+};
+
+template<typename Schema>
+std::optional<size_t> GeneratedParser<Schema>::FindLongName(std::string_view long_name) {
+    uint32_t bucket = HashName(long_name, 0) % Schema::kHashSeeds.size();
+    uint32_t slot = HashName(long_name, Schema::kHashSeeds[bucket]) & (Schema::kHashSlots.size() - 1);
+    int32_t index = Schema::kHashSlots[slot];
+
+    if (index < 0 || Schema::kArguments[index].long_name != long_name) {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(index);
+}
+
+template<typename Schema>
+std::optional<size_t> GeneratedParser<Schema>::GetValuesSet(std::string_view long_name) const {
+    std::optional<size_t> index = FindLongName(long_name);
+
+    if (!index.has_value()) {
+        return std::nullopt;
+    }
+
+    return values_set_[*index];
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::Parse(int argc, char** argv) {
+    return Parse(std::span<const char* const>(argv, argc));
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::Parse(std::span<const char* const> argv) {
+    argv_.assign(argv.begin(), argv.end());
+    return Parse(std::span<const std::string_view>(argv_));
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::Parse(const std::vector<std::string>& argv) {
+    argv_.assign(argv.begin(), argv.end());
+    return Parse(std::span<const std::string_view>(argv_));
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::Parse(std::span<const std::string_view> argv) {
+    options_ = Options{};
+    values_set_.fill(0);
+    error_ = ParsingError{};
+    need_help_ = false;
+    unused_positions_.clear();
+
+    for (size_t position = 1; position < argv.size(); ++position) {
+        std::string_view argument = argv[position];
+
+        if (argument.empty()) {
+            continue;
+        }
+
+        if (argument == "--") {
+            for (size_t i = position + 1; i < argv.size(); ++i) {
+                unused_positions_.push_back(i);
+            }
+
+            break;
+        }
+
+        if (argument[0] != '-' || argument.length() == 1) {
+            unused_positions_.push_back(position);
+            continue;
+        }
+
+        bool is_parsed = argument[1] == '-' ? ParseLongOption(argv, position) : ParseShortOptions(argv, position);
+
+        if (!is_parsed) {
+            return false;
+        }
+    }
+
+    if (!ParsePositionalArguments(argv)) {
+        return false;
+    }
+
+    if (need_help_) {
+        return true;
+    }
+
+    return HandleErrors();
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::SetValue(size_t index,
+                                       std::string_view value_string,
+                                       std::string_view argument_string) {
+    if (!Schema::SetValue(options_, index, value_string)) {
+        error_ = ParsingError{argument_string, ParsingErrorType::kInvalidArgument, Schema::kArguments[index].long_name};
+        return false;
+    }
+
+    ++values_set_[index];
+
+    if (index == Schema::kHelpIndex) {
+        need_help_ = true;
+    }
+
+    return true;
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::ParseLongOption(std::span<const std::string_view> argv, size_t& position) {
+    std::string_view argument = argv[position];
+    std::string_view name = argument.substr(2);
+    size_t equal_sign_index = name.find('=');
+    name = name.substr(0, equal_sign_index);
+
+    std::optional<size_t> index = FindLongName(name);
+
+    if (!index.has_value() || Schema::kArguments[*index].is_positional) {
+        error_ = ParsingError{argument, ParsingErrorType::kUnknownArgument, name};
+        return false;
+    }
+
+    if (equal_sign_index != std::string_view::npos) {
+        return SetValue(*index, argument.substr(equal_sign_index + 3), argument);
+    }
+
+    if (Schema::kArguments[*index].is_flag) {
+        return SetValue(*index, std::string_view(), argument);
+    }
+
+    if (position == argv.size() - 1) {
+        error_ = ParsingError{argument, ParsingErrorType::kInsufficent, Schema::kArguments[*index].long_name};
+        return false;
+    }
+
+    ++position;
+    return SetValue(*index, argv[position], argument);
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::ParseShortOptions(std::span<const std::string_view> argv, size_t& position) {
+    std::string_view argument = argv[position];
+    std::string_view names = argument.substr(1);
+
+    std::optional<size_t> first_index = Schema::FindShortName(names[0]);
+
+    if (!first_index.has_value() || Schema::kArguments[*first_index].is_positional) {
+        error_ = ParsingError{argument, ParsingErrorType::kUnknownArgument};
+        return false;
+    }
+
+    const GeneratedArgument& first = Schema::kArguments[*first_index];
+
+    if (names.length() == 1) {
+        if (first.is_flag) {
+            return SetValue(*first_index, std::string_view(), argument);
+        }
+
+        if (position == argv.size() - 1) {
+            error_ = ParsingError{argument, ParsingErrorType::kInsufficent, first.long_name};
+            return false;
+        }
+
+        ++position;
+        return SetValue(*first_index, argv[position], argument);
+    }
+
+    // "-n=5", "-n5" and "-Dkey=value" give the value to the first option
+    if (!first.is_flag) {
+        std::string_view value_string = names.substr(1);
+
+        if (value_string[0] == '=') {
+            value_string = value_string.substr(1);
+        }
+
+        return SetValue(*first_index, value_string, argument);
+    }
+
+    // "-abc" is a group of flags
+    for (char short_name : names) {
+        std::optional<size_t> index = Schema::FindShortName(short_name);
+
+        if (!index.has_value() || !Schema::kArguments[*index].is_flag) {
+            error_ = ParsingError{argument, ParsingErrorType::kUnknownArgument, first.long_name};
+            return false;
+        }
+
+        if (!SetValue(*index, std::string_view(), argument)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::ParsePositionalArguments(std::span<const std::string_view> argv) {
+    if (Schema::kPositionalArguments.empty()) {
+        if (!unused_positions_.empty()) {
+            error_ = ParsingError{argv[unused_positions_[0]], ParsingErrorType::kUnknownArgument};
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t position_index = 0;
+
+    for (size_t index : Schema::kPositionalArguments) {
+        if (position_index == unused_positions_.size()) {
+            break;
+        }
+
+        do {
+            std::string_view argument = argv[unused_positions_[position_index++]];
+
+            if (!SetValue(index, argument, argument)) {
+                return false;
+            }
+        } while (Schema::kArguments[index].is_multi_value && position_index < unused_positions_.size());
+    }
+
+    return true;
+}
+
+template<typename Schema>
+bool GeneratedParser<Schema>::HandleErrors() {
+    for (size_t index = 0; index < Schema::kArguments.size(); ++index) {
+        const GeneratedArgument& argument = Schema::kArguments[index];
+
+        if (argument.has_default) {
+            continue;
+        }
+
+        if (values_set_[index] == 0) {
+            error_ = ParsingError{std::string_view(), ParsingErrorType::kNoArgument, argument.long_name};
+            return false;
+        }
+
+        if (values_set_[index] < argument.minimum_values) {
+            error_ = ParsingError{std::string_view(), ParsingErrorType::kInsufficent, argument.long_name};
+            return false;
+        }
+    }
+
+    Schema::FinishValues(options_, values_set_);
+
+    return true;
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,426 @@
+#include "GlobExpander.hpp"
+#include "utils/utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE bool IsGlobPattern(std::string_view string) {
+    for (size_t i = 0; i < string.size(); ++i) {
+        if (string[i] == '\\') {
+            ++i;
+        } else if (string[i] == '*' || string[i] == '?' || string[i] == '[') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Matches the symbol against "[...]" at pattern[position]. Returns false if the class isn't closed,
+// then '[' is an ordinary symbol
+static bool MatchGlobClass(std::string_view pattern, size_t& position, char symbol, bool& is_matched) {
+    size_t i = position + 1;
+    bool is_negated = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+
+    if (is_negated) {
+        ++i;
+    }
+
+    is_matched = false;
+
+    // A ']' right after the opening is a member of the class
+    for (size_t first = i; i < pattern.size() && (pattern[i] != ']' || i == first); ++i) {
+        char low = pattern[i];
+
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            is_matched |= low <= symbol && symbol <= pattern[i + 2];
+            i += 2;
+        } else {
+            is_matched |= low == symbol;
+        }
+    }
+
+    if (i == pattern.size()) {
+        return false;
+    }
+
+    is_matched ^= is_negated;
+    position = i + 1;
+
+    return true;
+}
+
+// Matches one symbol of the name against the pattern at the position, except '*'
+static bool MatchGlobSymbol(std::string_view pattern, size_t& position, char symbol) {
+    char pattern_symbol = pattern[position];
+
+    if (pattern_symbol == '?') {
+        ++position;
+        return true;
+    }
+
+    if (pattern_symbol == '[') {
+        bool is_matched = false;
+
+        if (MatchGlobClass(pattern, position, symbol, is_matched)) {
+            return is_matched;
+        }
+    }
+
+    if (pattern_symbol == '\\' && position + 1 < pattern.size()) {
+        pattern_symbol = pattern[++position];
+    }
+
+    if (pattern_symbol != symbol) {
+        return false;
+    }
+
+    ++position;
+    return true;
+}
+
+ARGPARSER_INLINE bool MatchGlobSegment(std::string_view pattern, std::string_view name) {
+    if (!name.empty() && name[0] == '.' && (pattern.empty() || pattern[0] != '.')) {
+        return false;
+    }
+
+    size_t position = 0;
+    size_t name_position = 0;
+
+    // The last '*' and the position in the name it's retried from
+    size_t star_position = std::string_view::npos;
+    size_t star_name_position = 0;
+
+    while (name_position < name.size()) {
+        if (position < pattern.size() && pattern[position] == '*') {
+            star_position = ++position;
+            star_name_position = name_position;
+            continue;
+        }
+
+        if (position < pattern.size() && MatchGlobSymbol(pattern, position, name[name_position])) {
+            ++name_position;
+            continue;
+        }
+
+        if (star_position == std::string_view::npos) {
+            return false;
+        }
+
+        position = star_position;
+        name_position = ++star_name_position;
+    }
+
+    while (position < pattern.size() && pattern[position] == '*') {
+        ++position;
+    }
+
+    return position == pattern.size();
+}
+
+static std::string UnescapeGlob(std::string_view segment) {
+    std::string result;
+    result.reserve(segment.size());
+
+    for (size_t i = 0; i < segment.size(); ++i) {
+        if (segment[i] == '\\' && i + 1 < segment.size()) {
+            ++i;
+        }
+
+        result += segment[i];
+    }
+
+    return result;
+}
+
+static std::string JoinPath(std::string_view directory, std::string_view name) {
+    std::string path;
+    path.reserve(directory.size() + name.size() + 1);
+    path.append(directory);
+
+    if (!directory.empty() && directory.back() != '/') {
+        path += '/';
+    }
+
+    path.append(name);
+
+    return path;
+}
+
+// One expansion of a pattern by a pool of threads with a deque of directories each
+class GlobWalker {
+public:
+    GlobWalker(std::span<const std::string> segments, size_t max_threads)
+        : segments_(segments),
+          max_threads_(max_threads),
+          workers_(std::make_unique<Worker[]>(max_threads)) {}
+
+    void Run(std::string base, std::vector<std::string>& matches) {
+        Push(0, Task{std::move(base), 0});
+        Work(0);
+
+        {
+            std::lock_guard lock(threads_mutex_);
+
+            for (std::thread& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        for (size_t i = 0; i < max_threads_; ++i) {
+            std::vector<std::string>& worker_matches = workers_[i].matches;
+            std::move(worker_matches.begin(), worker_matches.end(), std::back_inserter(matches));
+        }
+    }
+
+private:
+    struct Task {
+        std::string directory;
+        // The segment which the entries of the directory are matched against
+        size_t segment = 0;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::vector<std::string> matches;
+    };
+
+    std::span<const std::string> segments_;
+    size_t max_threads_;
+    std::unique_ptr<Worker[]> workers_;
+
+    // The tasks in the deques, and the ones in the deques or being processed
+    std::atomic<size_t> queued_tasks_ = 0;
+    std::atomic<size_t> pending_tasks_ = 0;
+    std::atomic<size_t> workers_count_ = 1;
+
+    std::mutex idle_mutex_;
+    std::condition_variable task_added_;
+
+    std::mutex threads_mutex_;
+    std::vector<std::thread> threads_;
+
+    void Push(size_t worker, Task task) {
+        pending_tasks_.fetch_add(1);
+
+        {
+            std::lock_guard lock(workers_[worker].mutex);
+            workers_[worker].tasks.push_back(std::move(task));
+        }
+
+        queued_tasks_.fetch_add(1);
+
+        {
+            std::lock_guard lock(idle_mutex_);
+        }
+
+        task_added_.notify_one();
+
+        if (queued_tasks_.load() > 1 && workers_count_.load() < max_threads_) {
+            StartWorker();
+        }
+    }
+
+    void StartWorker() {
+        std::lock_guard lock(threads_mutex_);
+        size_t count = workers_count_.load();
+
+        if (count == max_threads_) {
+            return;
+        }
+
+        threads_.emplace_back(&GlobWalker::Work, this, count);
+        workers_count_.store(count + 1);
+    }
+
+    // The newest task of the worker, or the oldest task of another one
+    bool Pop(size_t worker, Task& task) {
+        {
+            std::lock_guard lock(workers_[worker].mutex);
+            std::deque<Task>& tasks = workers_[worker].tasks;
+
+            if (!tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                queued_tasks_.fetch_sub(1);
+                return true;
+            }
+        }
+
+        size_t workers_count = workers_count_.load();
+
+        for (size_t i = 1; i < workers_count; ++i) {
+            size_t victim = (worker + i) % workers_count;
+            std::lock_guard lock(workers_[victim].mutex);
+            std::deque<Task>& tasks = workers_[victim].tasks;
+
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                queued_tasks_.fetch_sub(1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Work(size_t worker) {
+        while (true) {
+            Task task;
+
+            if (Pop(worker, task)) {
+                Process(worker, task);
+
+                if (pending_tasks_.fetch_sub(1) == 1) {
+                    std::lock_guard lock(idle_mutex_);
+                    task_added_.notify_all();
+                }
+
+                continue;
+            }
+
+            std::unique_lock lock(idle_mutex_);
+            task_added_.wait(lock, [this] {
+                return queued_tasks_.load() > 0 || pending_tasks_.load() == 0;
+            });
+
+            if (pending_tasks_.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    void Process(size_t worker, const Task& task) {
+        const std::string& segment = segments_[task.segment];
+        bool is_globstar = segment == "**";
+
+        // A literal segment is looked up without reading the directory
+        if (!is_globstar && !IsGlobPattern(segment)) {
+            std::string path = JoinPath(task.directory, UnescapeGlob(segment));
+
+            if (task.segment + 1 < segments_.size()) {
+                Process(worker, Task{std::move(path), task.segment + 1});
+                return;
+            }
+
+            struct stat status;
+
+            if (lstat(path.c_str(), &status) == 0) {
+                workers_[worker].matches.push_back(std::move(path));
+            }
+
+            return;
+        }
+
+        DIR* directory = opendir(task.directory.empty() ? "." : task.directory.c_str());
+
+        if (directory == nullptr) {
+            return;
+        }
+
+        // "**" matches no directory as well, so the entries are matched against the next segment too
+        size_t next_segment = is_globstar ? task.segment + 1 : task.segment;
+
+        while (dirent* entry = readdir(directory)) {
+            std::string_view name = entry->d_name;
+
+            if (name == "." || name == "..") {
+                continue;
+            }
+
+            std::string path = JoinPath(task.directory, name);
+
+            if (is_globstar && name[0] != '.') {
+                if (IsDirectory(path, entry->d_type, false)) {
+                    Push(worker, Task{path, task.segment});
+                }
+
+                if (next_segment == segments_.size()) {
+                    workers_[worker].matches.push_back(std::move(path));
+                    continue;
+                }
+            }
+
+            if (next_segment == segments_.size() || !MatchGlobSegment(segments_[next_segment], name)) {
+                continue;
+            }
+
+            if (next_segment + 1 == segments_.size()) {
+                workers_[worker].matches.push_back(std::move(path));
+            } else if (IsDirectory(path, entry->d_type, true)) {
+                Push(worker, Task{std::move(path), next_segment + 1});
+            }
+        }
+
+        closedir(directory);
+    }
+
+    static bool IsDirectory(const std::string& path, unsigned char type, bool follow_links) {
+        if (type == DT_DIR) {
+            return true;
+        }
+
+        if (type != DT_UNKNOWN && (type != DT_LNK || !follow_links)) {
+            return false;
+        }
+
+        struct stat status;
+        int result = follow_links ? stat(path.c_str(), &status) : lstat(path.c_str(), &status);
+
+        return result == 0 && S_ISDIR(status.st_mode);
+    }
+};
+
+ARGPARSER_INLINE std::vector<std::string>& GlobExpander::Expand(std::string_view pattern) {
+    matches_.clear();
+
+    std::string base = pattern.starts_with('/') ? "/" : "";
+    std::vector<std::string> segments;
+    bool is_base = true;
+
+    for (size_t start = 0; start <= pattern.size();) {
+        size_t end = std::min(pattern.find('/', start), pattern.size());
+        std::string_view segment = pattern.substr(start, end - start);
+        start = end + 1;
+
+        if (segment.empty() || (segment == "**" && !segments.empty() && segments.back() == "**")) {
+            continue;
+        }
+
+        // The literal segments before the first pattern are the directory the walk starts from
+        if (is_base && segment != "**" && !IsGlobPattern(segment)) {
+            base = JoinPath(base, UnescapeGlob(segment));
+            continue;
+        }
+
+        is_base = false;
+        segments.emplace_back(segment);
+    }
+
+    if (segments.empty()) {
+        return matches_;
+    }
+
+    GlobWalker(segments, max_threads_).Run(std::move(base), matches_);
+
+    // A path may be reached twice through the different splits of "a/**/b/**/c"
+    std::sort(matches_.begin(), matches_.end());
+    matches_.erase(std::unique(matches_.begin(), matches_.end()), matches_.end());
+
+    return matches_;
+}
+
+} // namespace ArgumentParser
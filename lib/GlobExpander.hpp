@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// Whether the string has an unescaped '*', '?' or '['
+bool IsGlobPattern(std::string_view string);
+
+// Matches a name against one segment of a pattern: '*', '?', "[a-z]", "[!a-z]" and "\*".
+// A leading '.' of the name is matched only by a '.' in the pattern, like in the shell
+bool MatchGlobSegment(std::string_view pattern, std::string_view name);
+
+// Expands glob patterns like "data/**/*.parquet", where "**" is any number of directories.
+// "**" doesn't follow the symbolic links to directories and skips the hidden ones.
+// The directories are read by up to max_threads threads. Each of them takes the directories
+// it found itself first, and steals the oldest directories of the others when it runs out of them,
+// so a large tree is spread between the threads. A thread is started only when there are directories waiting
+class GlobExpander {
+public:
+    static constexpr size_t kMaxThreads = 16;
+
+    explicit GlobExpander(size_t max_threads = kMaxThreads)
+        : max_threads_(max_threads == 0 ? 1 : max_threads) {}
+
+    // The matching paths in the sorted order. The vector is reused by the next call
+    std::vector<std::string>& Expand(std::string_view pattern);
+
+private:
+    size_t max_threads_;
+    std::vector<std::string> matches_;
+};
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "GlobExpander.cpp"
+#endif
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "FormatValue.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ArgumentParser {
+
+// The value of a "-D key=value" argument: all the occurrences of the argument are collected into one map.
+// The keys and values are copied into blocks owned by the map, so the map doesn't depend on the argv
+// or on the reused buffers of a stream. The entries are kept in the order of insertion, and an open-addressing table with linear probing indexes them.
+class KeyValueMap {
+public:
+    enum class DuplicatePolicy {
+        // The last value of a repeated key wins, like in "-Dx=1 -Dx=2"
+        kReplace,
+        kKeepFirst,
+        // A repeated key is an error of the parsing
+        kReject
+    };
+
+    using Entry = std::pair<std::string_view, std::string_view>;
+
+    explicit KeyValueMap(DuplicatePolicy policy = DuplicatePolicy::kReplace)
+        : policy_(policy) {}
+
+    // The copy gets its own blocks, the views of the entries can't point into the other map
+    KeyValueMap(const KeyValueMap& other)
+        : policy_(other.policy_) {
+        Reserve(other.Size());
+
+        for (const auto& [key, value] : other) {
+            Insert(key, value);
+        }
+    }
+
+    KeyValueMap& operator=(const KeyValueMap& other) {
+        if (this != &other) {
+            *this = KeyValueMap(other);
+        }
+
+        return *this;
+    }
+
+    // The blocks don't move, so the views stay valid
+    KeyValueMap(KeyValueMap&& other) noexcept = default;
+    KeyValueMap& operator=(KeyValueMap&& other) noexcept = default;
+
+    // Splits the token at the first '='. Returns false if there is no '=' or the key is empty
+    bool Add(std::string_view token) {
+        size_t equal_sign_index = token.find('=');
+
+        if (equal_sign_index == std::string_view::npos || equal_sign_index == 0) {
+            return false;
+        }
+
+        return Insert(token.substr(0, equal_sign_index), token.substr(equal_sign_index + 1));
+    }
+
+    // Returns false if the key is already present and the policy is kReject
+    bool Insert(std::string_view key, std::string_view value) {
+        if ((entries_.size() + 1) * kMaxLoadDenominator > slots_.size() * kMaxLoadNumerator) {
+            Rehash(slots_.empty() ? kMinSlots : slots_.size() * 2);
+        }
+
+        size_t hash = std::hash<std::string_view>{}(key);
+        size_t slot_index = FindSlot(key, hash);
+        Slot& slot = slots_[slot_index];
+
+        if (slot.entry_index != kEmptySlot) {
+            Entry& entry = entries_[slot.entry_index - 1];
+
+            if (policy_ == DuplicatePolicy::kReplace) {
+                entry.second = Store(value);
+            }
+
+            return policy_ != DuplicatePolicy::kReject;
+        }
+
+        entries_.emplace_back(Store(key), Store(value));
+        slot = Slot{static_cast<uint32_t>(entries_.size()), GetTag(hash)};
+
+        return true;
+    }
+
+    std::optional<std::string_view> Find(std::string_view key) const {
+        if (entries_.empty()) {
+            return std::nullopt;
+        }
+
+        const Slot& slot = slots_[FindSlot(key, std::hash<std::string_view>{}(key))];
+
+        if (slot.entry_index == kEmptySlot) {
+            return std::nullopt;
+        }
+
+        return entries_[slot.entry_index - 1].second;
+    }
+
+    bool Contains(std::string_view key) const {
+        return Find(key).has_value();
+    }
+
+    void Reserve(size_t count) {
+        size_t slots_count = kMinSlots;
+
+        while (count * kMaxLoadDenominator > slots_count * kMaxLoadNumerator) {
+            slots_count *= 2;
+        }
+
+        if (slots_count > slots_.size()) {
+            Rehash(slots_count);
+        }
+
+        entries_.reserve(count);
+    }
+
+    size_t Size() const {
+        return entries_.size();
+    }
+
+    bool Empty() const {
+        return entries_.empty();
+    }
+
+    DuplicatePolicy GetDuplicatePolicy() const {
+        return policy_;
+    }
+
+    std::vector<Entry>::const_iterator begin() const {
+        return entries_.begin();
+    }
+
+    std::vector<Entry>::const_iterator end() const {
+        return entries_.end();
+    }
+
+    // The maps are equal if they have the same entries, in any order
+    friend bool operator==(const KeyValueMap& lhs, const KeyValueMap& rhs) {
+        if (lhs.Size() != rhs.Size()) {
+            return false;
+        }
+
+        for (const auto& [key, value] : lhs) {
+            if (rhs.Find(key) != value) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct Slot {
+        // An index in entries_ + 1, or kEmptySlot
+        uint32_t entry_index = 0;
+        // The upper bits of the hash, so that most of the collisions don't compare the keys
+        uint32_t tag = 0;
+    };
+
+    static constexpr uint32_t kEmptySlot = 0;
+    static constexpr size_t kMinSlots = 16;
+
+    static constexpr size_t kMinBlockSize = 256;
+    static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+    // At most 3/4 of the slots are used
+    static constexpr size_t kMaxLoadNumerator = 3;
+    static constexpr size_t kMaxLoadDenominator = 4;
+
+    std::vector<Entry> entries_;
+    std::vector<Slot> slots_;
+    DuplicatePolicy policy_;
+
+    // The keys and values are appended to the last block
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_ = 0;
+    size_t block_used_ = 0;
+
+    std::string_view Store(std::string_view string) {
+        if (string.empty()) {
+            return {};
+        }
+
+        if (blocks_.empty() || string.size() > block_size_ - block_used_) {
+            block_size_ = std::max(string.size(), std::clamp(block_size_ * 2, kMinBlockSize, kMaxBlockSize));
+            block_used_ = 0;
+            blocks_.push_back(std::make_unique_for_overwrite<char[]>(block_size_));
+        }
+
+        char* data = blocks_.back().get() + block_used_;
+        std::memcpy(data, string.data(), string.size());
+        block_used_ += string.size();
+
+        return {data, string.size()};
+    }
+
+    static uint32_t GetTag(size_t hash) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+    }
+
+    // The slot with the key, or the empty slot where it should be inserted
+    size_t FindSlot(std::string_view key, size_t hash) const {
+        size_t mask = slots_.size() - 1;
+        uint32_t tag = GetTag(hash);
+
+        for (size_t slot_index = hash & mask;; slot_index = (slot_index + 1) & mask) {
+            const Slot& slot = slots_[slot_index];
+
+            if (slot.entry_index == kEmptySlot
+                || (slot.tag == tag && entries_[slot.entry_index - 1].first == key)) {
+                return slot_index;
+            }
+        }
+    }
+
+    void Rehash(size_t slots_count) {
+        slots_.assign(slots_count, Slot{});
+        size_t mask = slots_count - 1;
+
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            size_t hash = std::hash<std::string_view>{}(entries_[i].first);
+            size_t slot_index = hash & mask;
+
+            while (slots_[slot_index].entry_index != kEmptySlot) {
+                slot_index = (slot_index + 1) & mask;
+            }
+
+            slots_[slot_index] = Slot{static_cast<uint32_t>(i + 1), GetTag(hash)};
+        }
+    }
+};
+
+template<>
+inline std::string FormatValue<KeyValueMap>(const KeyValueMap& value) {
+    std::string result;
+
+    for (const auto& [key, entry_value] : value) {
+        if (!result.empty()) {
+            result += ',';
+        }
+
+        result.append(key).append("=").append(entry_value);
+    }
+
+    return result;
+}
+
+} // namespace ArgumentParser
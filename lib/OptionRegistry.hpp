@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string_view>
+
+// On ELF platforms the options are registered by placing pointers to them into one section,
+// and the linker provides the bounds of the section. Otherwise every option links itself
+// into a list from a static constructor
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && !defined(ARGPARSER_NO_OPTION_SECTIONS)
+#define ARGPARSER_OPTION_SECTIONS
+#endif
+
+namespace ArgumentParser {
+
+class ArgParser;
+
+// An option defined by ARGPARSER_DEFINE_OPTION. The node is constant-initialized,
+// and it's added to a parser as an argument on the first Parse, see ArgParser::UseDefinedOptions()
+struct OptionNode {
+    std::string_view long_name;
+    std::string_view description;
+    void (*add_to_parser)(ArgParser& parser, OptionNode& node) = nullptr;
+
+    // The list of the options registered by the static constructors, without the sections
+    OptionNode* next = nullptr;
+};
+
+#ifndef ARGPARSER_OPTION_SECTIONS
+inline constinit OptionNode* defined_options_head = nullptr;
+
+struct OptionRegistrar {
+    explicit OptionRegistrar(OptionNode& node) {
+        node.next = defined_options_head;
+        defined_options_head = &node;
+    }
+};
+#endif
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_OPTION_SECTIONS
+// Defined by the linker if at least one option is defined, otherwise they are null
+extern "C" {
+[[gnu::weak]] extern ArgumentParser::OptionNode* const __start_argparser_options[];
+[[gnu::weak]] extern ArgumentParser::OptionNode* const __stop_argparser_options[];
+}
+#endif
+
+namespace ArgumentParser {
+
+template<typename OnOption>
+void ForEachDefinedOption(OnOption on_option) {
+#ifdef ARGPARSER_OPTION_SECTIONS
+    if (__start_argparser_options == nullptr) {
+        return;
+    }
+
+    for (OptionNode* const* node = __start_argparser_options; node != __stop_argparser_options; ++node) {
+        on_option(**node);
+    }
+#else
+    for (OptionNode* node = defined_options_head; node != nullptr; node = node->next) {
+        on_option(*node);
+    }
+#endif
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,144 @@
+#include "ParseObserver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace ArgumentParser {
+
+namespace detail {
+
+inline constexpr std::array<std::pair<ParsePhase, std::string_view>, 6> kPhaseNames = {{
+    {ParsePhase::kTokenClassification, "token classification"},
+    {ParsePhase::kNameLookup, "name lookup"},
+    {ParsePhase::kValueConversion, "value conversion"},
+    {ParsePhase::kPositionalAssignment, "positional assignment"},
+    {ParsePhase::kErrorHandling, "error handling"},
+    {ParsePhase::kHelpRendering, "help rendering"},
+}};
+
+ARGPARSER_INLINE std::string DemangleTypeName(std::string_view type_name) {
+    std::string result{type_name};
+
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(result.c_str(), nullptr, nullptr, &status);
+
+    if (status == 0 && demangled != nullptr) {
+        result = demangled;
+    }
+
+    std::free(demangled);
+#endif
+
+    return result;
+}
+
+ARGPARSER_INLINE std::string FormatRow(std::string_view name,
+                                       std::string_view type,
+                                       const ParseStatisticsCollector::Statistics& statistics) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "%-32.*s %10zu %10zu %14.3f",
+                  static_cast<int>(name.length()), name.data(),
+                  statistics.events,
+                  statistics.count,
+                  std::chrono::duration<double, std::micro>(statistics.time).count());
+
+    std::string result = buffer;
+
+    if (!type.empty()) {
+        result += "  ";
+        result += type;
+    }
+
+    result += '\n';
+
+    return result;
+}
+
+} // namespace detail
+
+ARGPARSER_INLINE void ParseStatisticsCollector::OnEvent(const ParseEvent& event) {
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(event.end - event.start);
+
+    Statistics& phase = phases_[event.phase];
+    ++phase.events;
+    phase.count += event.count;
+    phase.time += time;
+
+    if (event.argument_name.empty()) {
+        return;
+    }
+
+    auto it = arguments_.find(event.argument_name);
+
+    if (it == arguments_.end()) {
+        it = arguments_.emplace(std::string(event.argument_name), Statistics{}).first;
+        argument_types_.emplace(std::string(event.argument_name), detail::DemangleTypeName(event.argument_type));
+    }
+
+    ++it->second.events;
+    it->second.count += event.count;
+    it->second.time += time;
+}
+
+ARGPARSER_INLINE const ParseStatisticsCollector::Statistics& ParseStatisticsCollector::GetPhaseStatistics(ParsePhase phase) const {
+    static const Statistics kEmpty;
+
+    auto it = phases_.find(phase);
+    return (it == phases_.end()) ? kEmpty : it->second;
+}
+
+ARGPARSER_INLINE const std::map<std::string, ParseStatisticsCollector::Statistics, std::less<>>&
+ParseStatisticsCollector::GetArgumentStatistics() const {
+    return arguments_;
+}
+
+ARGPARSER_INLINE std::string ParseStatisticsCollector::Report() const {
+    std::string result = "Phases:\n";
+
+    char header[256];
+    std::snprintf(header, sizeof(header), "%-32s %10s %10s %14s", "", "events", "count", "time, us");
+
+    result += header;
+    result += '\n';
+
+    for (const auto& [phase, name] : detail::kPhaseNames) {
+        result += detail::FormatRow(name, "", GetPhaseStatistics(phase));
+    }
+
+    std::vector<std::pair<std::string_view, const Statistics*>> arguments;
+    arguments.reserve(arguments_.size());
+
+    for (const auto& [name, statistics] : arguments_) {
+        arguments.emplace_back(name, &statistics);
+    }
+
+    std::stable_sort(arguments.begin(), arguments.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second->time > rhs.second->time;
+    });
+
+    result += "Arguments:\n";
+    result += header;
+    result += "  type\n";
+
+    for (const auto& [name, statistics] : arguments) {
+        result += detail::FormatRow(name, argument_types_.find(name)->second, *statistics);
+    }
+
+    return result;
+}
+
+ARGPARSER_INLINE void ParseStatisticsCollector::Reset() {
+    phases_.clear();
+    arguments_.clear();
+    argument_types_.clear();
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "utils/utils.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser {
+
+enum class ParsePhase {
+    kTokenClassification,
+    kNameLookup,
+    kValueConversion,
+    kPositionalAssignment,
+    kErrorHandling,
+    kHelpRendering
+};
+
+struct ParseEvent {
+    ParsePhase phase;
+    std::string_view argument_name;
+    std::string_view argument_type;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    size_t count = 1;
+};
+
+class ParseObserver {
+public:
+    virtual ~ParseObserver() = default;
+    virtual void OnEvent(const ParseEvent& event) = 0;
+};
+
+// Aggregates the events by phase and by argument
+class ParseStatisticsCollector : public ParseObserver {
+public:
+    struct Statistics {
+        size_t events = 0;
+        size_t count = 0;
+        std::chrono::nanoseconds time{0};
+    };
+
+    void OnEvent(const ParseEvent& event) override;
+
+    const Statistics& GetPhaseStatistics(ParsePhase phase) const;
+    const std::map<std::string, Statistics, std::less<>>& GetArgumentStatistics() const;
+
+    std::string Report() const;
+    void Reset();
+
+private:
+    std::map<ParsePhase, Statistics> phases_;
+    std::map<std::string, Statistics, std::less<>> arguments_;
+    std::map<std::string, std::string, std::less<>> argument_types_;
+};
+
+// Measures the time of a phase and reports it to the observer when stopped or destroyed.
+// Without ARGPARSER_INSTRUMENTATION it's an empty object and every call compiles away.
+#ifdef ARGPARSER_INSTRUMENTATION
+
+class PhaseTimer {
+public:
+    PhaseTimer(ParseObserver* observer,
+               ParsePhase phase,
+               std::string_view argument_name = {},
+               std::string_view argument_type = {})
+        : observer_(observer),
+          event_{phase, argument_name, argument_type} {
+        if (observer_ != nullptr) {
+            event_.start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        Stop();
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    void SetCount(size_t count) {
+        event_.count = count;
+    }
+
+    void Stop() {
+        if (observer_ == nullptr) {
+            return;
+        }
+
+        event_.end = std::chrono::steady_clock::now();
+        observer_->OnEvent(event_);
+        observer_ = nullptr;
+    }
+
+private:
+    ParseObserver* observer_;
+    ParseEvent event_;
+};
+
+#else
+
+class PhaseTimer {
+public:
+    PhaseTimer(ParseObserver*, ParsePhase, std::string_view = {}, std::string_view = {}) {}
+
+    void SetCount(size_t) {}
+    void Stop() {}
+};
+
+#endif
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "ParseObserver.cpp"
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "utils/utils.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ArgumentParser {
+
+// Converts a string from argv to the value of an argument.
+// The converters are defined inline, so that they can be inlined into SpecificArgument::ParseArgument,
+// and a converter for a user type may be registered from a header too.
+template<typename T>
+std::optional<T> ParseValue(std::string_view value_string);
+
+template<typename T>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<T> ParseIntegerValue(std::string_view value_string) {
+    auto parsing_result = ParseNumber<T>(value_string);
+    if (!parsing_result.has_value()) {
+        return std::nullopt;
+    }
+
+    return parsing_result.value();
+}
+
+template<typename T>
+std::optional<T> ParseFloatingPointValue(std::string_view value_string) {
+    auto parsing_result = ParseNumber<T>(value_string);
+    if (!parsing_result.has_value()) {
+        return std::nullopt;
+    }
+
+    return parsing_result.value();
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<int32_t> ParseValue<int32_t>(std::string_view value_string) {
+    return ParseIntegerValue<int32_t>(value_string);
+}
+
+template<>
+constexpr std::optional<std::string> ParseValue<std::string>(std::string_view value_string) {
+    return std::string(value_string);
+}
+
+template<>
+constexpr std::optional<bool> ParseValue<bool>(std::string_view value_string) {
+    if (!value_string.empty()) {
+        return std::nullopt;
+    }
+
+    return true;
+}
+
+template<>
+inline std::optional<double> ParseValue<double>(std::string_view value_string) {
+    return ParseFloatingPointValue<double>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<int64_t> ParseValue<int64_t>(std::string_view value_string) {
+    return ParseIntegerValue<int64_t>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<int16_t> ParseValue<int16_t>(std::string_view value_string) {
+    return ParseIntegerValue<int16_t>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<uint64_t> ParseValue<uint64_t>(std::string_view value_string) {
+    return ParseIntegerValue<uint64_t>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<uint32_t> ParseValue<uint32_t>(std::string_view value_string) {
+    return ParseIntegerValue<uint32_t>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<uint16_t> ParseValue<uint16_t>(std::string_view value_string) {
+    return ParseIntegerValue<uint16_t>(value_string);
+}
+
+template<>
+ARGPARSER_CONSTEXPR_CHARCONV std::optional<uint8_t> ParseValue<uint8_t>(std::string_view value_string) {
+    return ParseIntegerValue<uint8_t>(value_string);
+}
+
+template<>
+inline std::optional<float> ParseValue<float>(std::string_view value_string) {
+    return ParseFloatingPointValue<float>(value_string);
+}
+
+template<>
+inline std::optional<long double> ParseValue<long double>(std::string_view value_string) {
+    return ParseFloatingPointValue<long double>(value_string);
+}
+
+template<>
+constexpr std::optional<char> ParseValue<char>(std::string_view value_string) {
+    if (value_string.length() != 1) {
+        return std::nullopt;
+    }
+
+    return value_string[0];
+}
+
+} // namespace ArgumentParser
@@ -0,0 +1,425 @@
+#include "PathCheck.hpp"
+#include "utils/utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ARGPARSER_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace ArgumentParser {
+
+static std::filesystem::file_type GetFileType(unsigned mode) {
+    switch (mode & S_IFMT) {
+        case S_IFREG:
+            return std::filesystem::file_type::regular;
+        case S_IFDIR:
+            return std::filesystem::file_type::directory;
+        case S_IFLNK:
+            return std::filesystem::file_type::symlink;
+        case S_IFBLK:
+            return std::filesystem::file_type::block;
+        case S_IFCHR:
+            return std::filesystem::file_type::character;
+        case S_IFIFO:
+            return std::filesystem::file_type::fifo;
+        case S_IFSOCK:
+            return std::filesystem::file_type::socket;
+        default:
+            return std::filesystem::file_type::unknown;
+    }
+}
+
+static PathMetadata GetFailedMetadata(int error) {
+    PathMetadata metadata;
+    metadata.error = error;
+
+    if (error == ENOENT || error == ENOTDIR) {
+        metadata.type = std::filesystem::file_type::not_found;
+    }
+
+    return metadata;
+}
+
+static std::chrono::system_clock::time_point GetTimePoint(int64_t seconds, int64_t nanoseconds) {
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds)));
+}
+
+static PathMetadata StatPath(const char* path) {
+    struct stat status;
+
+    if (stat(path, &status) != 0) {
+        return GetFailedMetadata(errno);
+    }
+
+    PathMetadata metadata;
+    metadata.type = GetFileType(status.st_mode);
+    metadata.permissions = static_cast<std::filesystem::perms>(status.st_mode & 07777);
+    metadata.owner = status.st_uid;
+    metadata.group = status.st_gid;
+    metadata.size = static_cast<uint64_t>(status.st_size);
+    metadata.modification_time = GetTimePoint(status.st_mtim.tv_sec, status.st_mtim.tv_nsec);
+
+    return metadata;
+}
+
+ARGPARSER_INLINE UserCredentials UserCredentials::GetCurrent() {
+    UserCredentials credentials;
+    credentials.user = geteuid();
+    credentials.group = getegid();
+
+    int groups_count = getgroups(0, nullptr);
+
+    if (groups_count > 0) {
+        std::vector<gid_t> groups(groups_count);
+        groups_count = getgroups(groups_count, groups.data());
+
+        if (groups_count > 0) {
+            credentials.supplementary_groups.assign(groups.begin(), groups.begin() + groups_count);
+        }
+    }
+
+    return credentials;
+}
+
+ARGPARSER_INLINE bool UserCredentials::IsInGroup(uint32_t group_id) const {
+    return group_id == group
+        || std::find(supplementary_groups.begin(), supplementary_groups.end(), group_id) != supplementary_groups.end();
+}
+
+ARGPARSER_INLINE bool HasAccess(const PathMetadata& metadata, PathAccess access, const UserCredentials& credentials) {
+    if (!metadata.Exists()) {
+        return false;
+    }
+
+    unsigned mode = static_cast<unsigned>(metadata.permissions);
+    unsigned bit = (access == PathAccess::kRead) ? 4 : (access == PathAccess::kWrite) ? 2 : 1;
+
+    // root may read and write anything, and execute a file which is executable by someone
+    if (credentials.user == 0) {
+        return access != PathAccess::kExecute || metadata.IsDirectory() || (mode & 0111) != 0;
+    }
+
+    if (metadata.owner == credentials.user) {
+        return (mode >> 6) & bit;
+    }
+
+    if (credentials.IsInGroup(metadata.group)) {
+        return (mode >> 3) & bit;
+    }
+
+    return mode & bit;
+}
+
+ARGPARSER_INLINE bool PathRequirements::IsSatisfied(const PathMetadata& metadata,
+                                                    const UserCredentials& credentials) const {
+    if (!metadata.Exists()) {
+        return !must_exist && !is_directory && !is_regular_file && !is_readable && !is_writable && !is_executable;
+    }
+
+    if ((is_directory && !metadata.IsDirectory()) || (is_regular_file && !metadata.IsRegularFile())) {
+        return false;
+    }
+
+    return (!is_readable || HasAccess(metadata, PathAccess::kRead, credentials))
+        && (!is_writable || HasAccess(metadata, PathAccess::kWrite, credentials))
+        && (!is_executable || HasAccess(metadata, PathAccess::kExecute, credentials));
+}
+
+#ifdef ARGPARSER_HAS_IO_URING
+
+static PathMetadata ConvertStatx(const struct statx& status) {
+    PathMetadata metadata;
+    metadata.type = GetFileType(status.stx_mode);
+    metadata.permissions = static_cast<std::filesystem::perms>(status.stx_mode & 07777);
+    metadata.owner = status.stx_uid;
+    metadata.group = status.stx_gid;
+    metadata.size = status.stx_size;
+    metadata.modification_time = GetTimePoint(status.stx_mtime.tv_sec, status.stx_mtime.tv_nsec);
+
+    return metadata;
+}
+
+// A minimal io_uring, which only submits statx requests. It's set up by the raw system calls,
+// so there is no dependency on liburing
+class StatxRing {
+public:
+    explicit StatxRing(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+
+        if (fd_ < 0) {
+            return;
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        is_single_mmap_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (is_single_mmap_) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ring_ = is_single_mmap_
+            ? sq_ring_
+            : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) {
+                munmap(sqes, sqes_size_);
+            }
+
+            Unmap();
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+
+        char* sq_ring = static_cast<char*>(sq_ring_);
+        char* cq_ring = static_cast<char*>(cq_ring_);
+
+        sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+        capacity_ = params.sq_entries;
+
+        cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+    }
+
+    ~StatxRing() {
+        if (fd_ < 0) {
+            return;
+        }
+
+        munmap(sqes_, sqes_size_);
+        Unmap();
+        close(fd_);
+    }
+
+    StatxRing(const StatxRing&) = delete;
+    StatxRing& operator=(const StatxRing&) = delete;
+
+    bool IsValid() const {
+        return fd_ >= 0;
+    }
+
+    bool SupportsStatx() const {
+        constexpr unsigned kProbedOperations = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) + kProbedOperations * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, kProbedOperations) < 0) {
+            return false;
+        }
+
+        return probe->last_op >= IORING_OP_STATX && (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    // Stats all the paths, at most capacity_ at a time. results[i] is 0 or -errno
+    bool Run(std::span<const char* const> paths, std::span<struct statx> buffers, std::span<int> results) {
+        for (size_t chunk_start = 0; chunk_start < paths.size(); chunk_start += capacity_) {
+            size_t chunk_end = std::min(paths.size(), chunk_start + capacity_);
+            unsigned tail = *sq_tail_;
+
+            for (size_t i = chunk_start; i < chunk_end; ++i, ++tail) {
+                unsigned index = tail & sq_mask_;
+                io_uring_sqe& sqe = sqes_[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+
+                sqe.opcode = IORING_OP_STATX;
+                sqe.fd = AT_FDCWD;
+                sqe.addr = reinterpret_cast<uint64_t>(paths[i]);
+                sqe.len = STATX_BASIC_STATS;
+                sqe.off = reinterpret_cast<uint64_t>(&buffers[i]);
+                sqe.user_data = i;
+                sq_array_[index] = index;
+            }
+
+            std::atomic_ref<unsigned>(*sq_tail_).store(tail, std::memory_order_release);
+
+            if (!Wait(static_cast<unsigned>(chunk_end - chunk_start), results)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    int fd_ = -1;
+
+    void* sq_ring_ = MAP_FAILED;
+    void* cq_ring_ = MAP_FAILED;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    size_t sqes_size_ = 0;
+    bool is_single_mmap_ = false;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned capacity_ = 0;
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    void Unmap() {
+        if (sq_ring_ != MAP_FAILED) {
+            munmap(sq_ring_, sq_ring_size_);
+        }
+
+        if (!is_single_mmap_ && cq_ring_ != MAP_FAILED) {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+    }
+
+    // Submits the queued requests and reaps their completions. If the submission fails,
+    // the requests in flight are still waited for, as they write into the buffers
+    bool Wait(unsigned count, std::span<int> results) {
+        unsigned submitted = 0;
+        unsigned completed = 0;
+        bool has_failed = false;
+
+        while (completed < (has_failed ? submitted : count)) {
+            unsigned to_submit = has_failed ? 0 : count - submitted;
+            long entered = syscall(__NR_io_uring_enter, fd_, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+            if (entered >= 0) {
+                submitted += static_cast<unsigned>(entered);
+            } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                if (has_failed) {
+                    break;
+                }
+
+                has_failed = true;
+            }
+
+            unsigned head = *cq_head_;
+            unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+
+            for (; head != tail; ++head, ++completed) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                results[cqe.user_data] = cqe.res;
+            }
+
+            std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+        }
+
+        return !has_failed;
+    }
+};
+
+#endif
+
+ARGPARSER_INLINE bool PathCheckBatch::IsIoUringAvailable() {
+#ifdef ARGPARSER_HAS_IO_URING
+    static const bool is_available = [] {
+        StatxRing ring(1);
+        return ring.IsValid() && ring.SupportsStatx();
+    }();
+
+    return is_available;
+#else
+    return false;
+#endif
+}
+
+ARGPARSER_INLINE void PathCheckBatch::Run() {
+    // A few paths are stat'ed faster than a ring is set up
+    constexpr size_t kMinIoUringBatch = 4;
+
+    if (paths_.size() < kMinIoUringBatch || !RunIoUring()) {
+        RunThreadPool();
+    }
+}
+
+ARGPARSER_INLINE bool PathCheckBatch::RunIoUring() {
+#ifdef ARGPARSER_HAS_IO_URING
+    constexpr size_t kMaxRingEntries = 256;
+
+    if (!IsIoUringAvailable()) {
+        return false;
+    }
+
+    StatxRing ring(static_cast<unsigned>(std::min(paths_.size(), kMaxRingEntries)));
+
+    if (!ring.IsValid()) {
+        return false;
+    }
+
+    std::vector<struct statx> buffers(paths_.size());
+    std::vector<int> errors(paths_.size());
+
+    if (!ring.Run(paths_, buffers, errors)) {
+        return false;
+    }
+
+    results_.resize(paths_.size());
+
+    for (size_t i = 0; i < paths_.size(); ++i) {
+        results_[i] = (errors[i] < 0) ? GetFailedMetadata(-errors[i]) : ConvertStatx(buffers[i]);
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+ARGPARSER_INLINE void PathCheckBatch::RunThreadPool(size_t max_threads) {
+    // The threads take the paths by small tasks, so a slow path doesn't hold back the others
+    constexpr size_t kPathsPerTask = 8;
+
+    results_.resize(paths_.size());
+
+    std::atomic<size_t> next_path = 0;
+
+    auto stat_paths = [this, &next_path] {
+        for (size_t start = next_path.fetch_add(kPathsPerTask); start < paths_.size();
+             start = next_path.fetch_add(kPathsPerTask)) {
+            for (size_t i = start; i < std::min(paths_.size(), start + kPathsPerTask); ++i) {
+                results_[i] = StatPath(paths_[i]);
+            }
+        }
+    };
+
+    size_t threads_count = std::min(max_threads, (paths_.size() + kPathsPerTask - 1) / kPathsPerTask);
+    std::vector<std::thread> threads;
+
+    // The calling thread is one of the workers
+    for (size_t i = 1; i < threads_count; ++i) {
+        threads.emplace_back(stat_paths);
+    }
+
+    stat_paths();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace ArgumentParser
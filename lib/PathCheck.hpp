@@ -0,0 +1,162 @@
+#pragma once
+
+#include "FormatValue.hpp"
+#include "ParseValue.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ArgumentParser {
+
+// The result of stat() of a path argument, so that the caller doesn't stat it again
+struct PathMetadata {
+    // errno of the failed stat(), or 0. ENOENT means that the path doesn't exist
+    int error = 0;
+
+    std::filesystem::file_type type = std::filesystem::file_type::none;
+    std::filesystem::perms permissions = std::filesystem::perms::none;
+    uint32_t owner = 0;
+    uint32_t group = 0;
+    uint64_t size = 0;
+    std::chrono::system_clock::time_point modification_time;
+
+    bool Exists() const {
+        return error == 0;
+    }
+
+    bool IsDirectory() const {
+        return type == std::filesystem::file_type::directory;
+    }
+
+    bool IsRegularFile() const {
+        return type == std::filesystem::file_type::regular;
+    }
+
+    bool operator==(const PathMetadata& other) const = default;
+};
+
+enum class PathAccess {
+    kRead,
+    kWrite,
+    kExecute
+};
+
+// The effective user and groups of the process. They're fetched once for a batch of checks
+struct UserCredentials {
+    uint32_t user = 0;
+    uint32_t group = 0;
+    std::vector<uint32_t> supplementary_groups;
+
+    static UserCredentials GetCurrent();
+
+    bool IsInGroup(uint32_t group_id) const;
+};
+
+// Checks the permission bits for the user and groups, like access() does.
+// ACLs and read-only mounts aren't taken into account
+bool HasAccess(const PathMetadata& metadata, PathAccess access, const UserCredentials& credentials);
+
+// The conditions on the values of a path argument
+struct PathRequirements {
+    // The metadata is collected even if there is no other requirement
+    bool collect_metadata = false;
+    bool must_exist = false;
+    bool is_directory = false;
+    bool is_regular_file = false;
+    bool is_readable = false;
+    bool is_writable = false;
+    bool is_executable = false;
+
+    bool IsEmpty() const {
+        return !collect_metadata && !must_exist && !is_directory && !is_regular_file
+            && !is_readable && !is_writable && !is_executable;
+    }
+
+    bool IsSatisfied(const PathMetadata& metadata, const UserCredentials& credentials) const;
+};
+
+// Stats a batch of paths at once. On Linux the batch is submitted to io_uring as statx requests,
+// which the kernel runs concurrently. If io_uring is unavailable (an old kernel or a seccomp filter),
+// the paths are split between a few threads.
+class PathCheckBatch {
+public:
+    // stat() mostly waits for the file system, so there may be more threads than cores
+    static constexpr size_t kMaxThreads = 16;
+
+    explicit PathCheckBatch(std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : paths_(memory),
+          results_(memory) {}
+
+    void Clear() {
+        paths_.clear();
+        results_.clear();
+    }
+
+    // The path must stay alive until Run() returns. Returns the index of its result
+    size_t Add(const std::filesystem::path& path) {
+        paths_.push_back(path.c_str());
+        return paths_.size() - 1;
+    }
+
+    size_t Size() const {
+        return paths_.size();
+    }
+
+    void Run();
+
+    // Returns false if io_uring is unavailable, then the results are unchanged
+    bool RunIoUring();
+    void RunThreadPool(size_t max_threads = kMaxThreads);
+
+    const PathMetadata& GetResult(size_t index) const {
+        return results_[index];
+    }
+
+    std::span<const PathMetadata> GetResults() const {
+        return results_;
+    }
+
+    // Whether the kernel supports statx requests through io_uring. Probed once
+    static bool IsIoUringAvailable();
+
+private:
+    std::pmr::vector<const char*> paths_;
+    std::pmr::vector<PathMetadata> results_;
+};
+
+// The checks of a path argument and the metadata of its values
+struct PathArgumentChecks {
+    PathRequirements requirements;
+
+    // The index of the first value in the batch
+    size_t first_result = 0;
+    std::vector<PathMetadata> metadata;
+};
+
+template<>
+inline std::optional<std::filesystem::path> ParseValue<std::filesystem::path>(std::string_view value_string) {
+    if (value_string.empty()) {
+        return std::nullopt;
+    }
+
+    return std::filesystem::path(value_string);
+}
+
+template<>
+inline std::string FormatValue<std::filesystem::path>(const std::filesystem::path& value) {
+    return value.string();
+}
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "PathCheck.cpp"
+#endif
@@ -1,17 +1,37 @@
 #pragma once
 
+#include "ArgHandle.hpp"
 #include "Argument.hpp"
+#include "ChoiceTable.hpp"
+#include "CountingMemoryResource.hpp"
+#include "FlagStore.hpp"
+#include "FormatValue.hpp"
+#include "GlobExpander.hpp"
+#include "ParseValue.hpp"
+#include "PathCheck.hpp"
+#include "TupleValue.hpp"
+#include "Utf8.hpp"
 #include "utils/utils.hpp"
 
+#include <algorithm>
+#include <bitset>
+#include <concepts>
 #include <cstddef>
+#include <filesystem>
+#include <span>
 #include <type_traits>
 #include <expected>
-#include <sstream>
+#include <iterator>
+#include <variant>
 
 namespace ArgumentParser {
 
+// A type whose values from all the occurrences of an argument are collected into one value,
+// like KeyValueMap. Add() returns false if the string is invalid
 template<typename T>
-std::optional<T> ParseValue(std::string_view value_string);
+concept AccumulatedValue = requires(T& value, std::string_view value_string) {
+    { value.Add(value_string) } -> std::same_as<bool>;
+};
 
 template<typename T>
 class SpecificArgument : public Argument {
@@ -19,58 +39,132 @@ public:
     SpecificArgument() = delete;
     SpecificArgument(char short_name,
                      const std::string& long_name,
-                     const std::string& description);
+                     const std::string& description,
+                     std::pmr::memory_resource* schema_memory = std::pmr::get_default_resource(),
+                     std::pmr::memory_resource* values_memory = std::pmr::get_default_resource());
 
-    ~SpecificArgument();
+    ~SpecificArgument() override = default;
     SpecificArgument(const SpecificArgument&) = delete;
     SpecificArgument& operator=(const SpecificArgument&) = delete;
 
     std::string_view GetType() const override;
+    size_t GetArity() const override;
+    std::string_view GetElementType() const override;
     ArgumentStatus GetValueStatus() const override;
     size_t GetValuesSet() const override;
 
-    std::expected<size_t, ParsingError> ParseArgument(const std::vector<std::string_view>& argv,
+    std::expected<size_t, ParsingError> ParseArgument(std::span<const std::string_view> argv,
                                                       size_t position) override;
 
+    bool IsGlob() const override;
+    std::expected<size_t, ParsingError> ParseGlob(std::string_view pattern, GlobExpander& expander) override;
+
     std::optional<T> GetValue(size_t index = 0) const;
 
+    // The values set by the last parse, without the default value
+    std::span<const T> GetValues() const requires (!std::is_same_v<T, bool>);
+
+    // Moves the values set by the last parse out of the argument
+    std::vector<T> TakeValues() requires (!std::is_same_v<T, bool>);
+
+    ArgHandle<T> Handle() const;
+    void SetIndex(size_t index, uint64_t generation);
+
     SpecificArgument& Default(T default_value);
     SpecificArgument& MultiValue(size_t min_values = 0);
-    SpecificArgument& Positional();
+    // A tuple takes the tokens following the option, so it can't be positional
+    SpecificArgument& Positional() requires (!TupleValue<T>);
     SpecificArgument& StoreValue(T& to);
     SpecificArgument& StoreValues(std::vector<T>& to);
 
+    // The value is written straight into the field, the argument keeps no value of its own.
+    // The current value of the field becomes the default one.
+    SpecificArgument& Bind(T& field);
+
+    template<size_t N>
+    SpecificArgument& StoreValue(std::bitset<N>& to, size_t position) requires std::is_same_v<T, bool>;
+
+    void SetFlagStore(FlagStore* store, size_t bit) requires std::is_same_v<T, bool>;
+    SpecificArgument& Choices(std::initializer_list<std::pair<std::string_view, T>> choices);
+
+    // The value must lie in [min_value, max_value]
+    SpecificArgument& Range(T min_value, T max_value) requires std::totally_ordered<T>;
+
+    // A value which isn't valid UTF-8 is an error
+    SpecificArgument& ValidateUtf8() requires (std::is_same_v<T, std::string> || AccumulatedValue<T>);
+
+    // The values of a path argument given on the command line are checked after the parsing,
+    // together with the ones of the other path arguments, see PathCheckBatch
+    SpecificArgument& MustExist() requires std::is_same_v<T, std::filesystem::path>;
+    SpecificArgument& IsDirectory() requires std::is_same_v<T, std::filesystem::path>;
+    SpecificArgument& IsRegularFile() requires std::is_same_v<T, std::filesystem::path>;
+    SpecificArgument& Readable() requires std::is_same_v<T, std::filesystem::path>;
+    SpecificArgument& Writable() requires std::is_same_v<T, std::filesystem::path>;
+    SpecificArgument& Executable() requires std::is_same_v<T, std::filesystem::path>;
+
+    // A positional value like "data/**/*.parquet" is expanded to the matching paths in the sorted order,
+    // see GlobExpander. A value without the glob characters is taken as is
+    SpecificArgument& Glob()
+        requires (std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>);
+
+    // Only collects the metadata of the values
+    SpecificArgument& WithMetadata() requires std::is_same_v<T, std::filesystem::path>;
+
+    // The metadata of the values set by the last parse, in the order of GetValues()
+    std::span<const PathMetadata> GetMetadata() const requires std::is_same_v<T, std::filesystem::path>;
+
     void Clear() override;
 
-    const std::string& GetDefaultValueString() const override;
+    void AddPathChecks(PathCheckBatch& batch) override;
+    std::expected<void, ParsingError> TakePathChecks(const PathCheckBatch& batch,
+                                                     const UserCredentials& credentials) override;
+
+    void SetObserver(ParseObserver* observer) override;
+
+    std::string_view GetDefaultValueString() const override;
     void SetDefaultValueString(const std::string& str) override;
 
-    const std::string& GetDescription() const override;
-    const std::string& GetLongName() const override;
+    std::string_view GetDescription() const override;
+    std::string_view GetLongName() const override;
     char GetShortName() const override;
     bool IsPositional() const override;
     bool IsMultiValue() const override;
     bool HasDefault() const override;
     size_t GetMinimumValues() const override;
+    std::span<const std::string_view> GetChoices() const override;
 
     bool IsFlag() const override;
 
+    size_t GetValuesMemoryUsage() const override;
+    bool HasSameValues(const Argument& other) const override;
+    void Destroy(std::pmr::memory_resource* memory) override;
+
 protected:
-    std::string long_name_;
+    std::pmr::memory_resource* schema_memory_;
+
+    // Counts the bytes of values_ and passes the allocations to the parser's resource
+    CountingMemoryResource values_memory_;
+
+    std::pmr::string long_name_;
     char short_name_ = kNoShortName;
-    std::string description_;
+    std::pmr::string description_;
 
     ArgumentStatus value_status_ = ArgumentStatus::kNoArgument;
 
-    T value_;
     T default_value_{};
-    std::string default_value_string_;
+
+    // Formatted on the first request, so building a parser does no formatting
+    mutable std::pmr::string default_value_string_;
+    mutable bool is_default_value_string_valid_ = false;
     bool was_default_value_string_set_ = false;
 
     T* store_value_to_ = nullptr;
     std::vector<T>* store_values_to_ = nullptr;
 
-    bool was_temp_vector_created_ = false;
+    // A single value is kept inline, the vector is used for multi value arguments
+    // or when a single value argument is repeated
+    std::optional<T> inline_value_;
+    std::pmr::vector<T> values_;
 
     size_t minimum_values_ = 0;
     bool is_multi_value_ = false;
@@ -78,37 +172,80 @@ protected:
     bool has_default_ = false;
     bool has_store_values_ = false;
     bool has_store_value_ = false;
+    bool is_bound_ = false;
+    bool validate_utf8_ = false;
+    bool is_glob_ = false;
 
     bool is_flag_ = false;
 
     size_t values_set_ = 0;
+
+    std::optional<ChoiceTable<T>> choices_;
+    std::optional<std::pair<T, T>> range_;
+
+    // Flags keep their values in the parser's FlagStore instead of store_values_to_
+    [[no_unique_address]] std::conditional_t<std::is_same_v<T, bool>, FlagBinding, std::monostate> flag_;
+
+    [[no_unique_address]] std::conditional_t<std::is_same_v<T, std::filesystem::path>,
+                                             PathArgumentChecks,
+                                             std::monostate> path_checks_;
+
+    ParseObserver* observer_ = nullptr;
+
+    // The index in the parser, see Handle()
+    size_t index_ = 0;
+    uint64_t generation_ = 0;
+
+    std::optional<T> ConvertValue(std::string_view value_string) const;
+
+    std::expected<size_t, ParsingError> ParseTuple(std::span<const std::string_view> argv, size_t position)
+        requires TupleValue<T>;
+
+    void StoreParsedValue(T&& value);
+    void AcceptValue(T&& value);
+    void UpdateValueStatus();
+    T& GetAccumulatedValue();
+    size_t GetStoredValuesCount() const;
+    const T& GetStoredValue(size_t index) const;
+
+    // The values are kept only in the StoreValue target. An accumulated value is collected there
+    // unless there is also a StoreValues vector
+    bool IsStoredInTarget() const {
+        return is_bound_ || (AccumulatedValue<T> && has_store_value_ && store_values_to_ == nullptr);
+    }
 };
 
 template<typename T>
 SpecificArgument<T>::SpecificArgument(char short_name,
                                       const std::string& long_name,
-                                      const std::string& description) 
-    : short_name_(short_name),
-      long_name_(long_name),
-      description_(description) {
-    if (std::is_same_v<bool, T>) {
-        default_value_string_ = "false";
+                                      const std::string& description,
+                                      std::pmr::memory_resource* schema_memory,
+                                      std::pmr::memory_resource* values_memory)
+    : schema_memory_(schema_memory),
+      values_memory_(values_memory),
+      long_name_(long_name, schema_memory),
+      short_name_(short_name),
+      description_(description, schema_memory),
+      default_value_string_(schema_memory),
+      values_(&values_memory_) {
+    if constexpr (std::is_same_v<bool, T>) {
         has_default_ = true;
         is_flag_ = true;
     }
-
-    store_values_to_ = new std::vector<T>;
-    was_temp_vector_created_ = true;
 }
 
 template <typename T>
 std::expected<size_t, ParsingError> SpecificArgument<T>::ParseArgument(
-    const std::vector<std::string_view>& argv,
+    std::span<const std::string_view> argv,
     size_t position) {
-    if (store_values_to_->empty()) {
+    if (values_set_ == 0) {
         value_status_ = ArgumentStatus::kSuccess;
     }
 
+    if constexpr (TupleValue<T>) {
+        return ParseTuple(argv, position);
+    }
+
     size_t current_used_positions = 1;
     
     std::string_view value_string = argv[position];
@@ -130,7 +267,8 @@ std::expected<size_t, ParsingError> SpecificArgument<T>::ParseArgument(
 
     size_t equal_sign_index = value_string.find('=');
 
-    if (!is_positional_ && equal_sign_index != std::string_view::npos) {
+    // The value of "-Dkey=value" is "key=value"
+    if (!is_positional_ && !is_short_with_value && equal_sign_index != std::string_view::npos) {
         value_string = value_string.substr(equal_sign_index + 1);
     } else if (std::is_same_v<bool, T>) {
         value_string = "";
@@ -145,81 +283,409 @@ std::expected<size_t, ParsingError> SpecificArgument<T>::ParseArgument(
         value_string = argv[position];
     }
 
-    auto parsing_result = ParseValue<T>(value_string);
+    PhaseTimer conversion_timer(observer_, ParsePhase::kValueConversion, long_name_, GetType());
 
-    if (!parsing_result.has_value()) {
+    if (validate_utf8_ && !IsValidUtf8(value_string)) {
         value_status_ = ArgumentStatus::kInvalidArgument;
         return std::unexpected(ParsingError{argv[position], ParsingErrorType::kInvalidArgument, long_name_});
     }
 
-    value_ = parsing_result.value();
+    if constexpr (AccumulatedValue<T>) {
+        if (!GetAccumulatedValue().Add(value_string)) {
+            value_status_ = ArgumentStatus::kInvalidArgument;
+            return std::unexpected(ParsingError{argv[position], ParsingErrorType::kInvalidArgument, long_name_});
+        }
+
+        conversion_timer.Stop();
+        ++values_set_;
+
+        // The map is collected in the StoreValues vector then, so the target gets a copy
+        if (has_store_value_ && !IsStoredInTarget()) {
+            *store_value_to_ = GetStoredValue(0);
+        }
+    } else {
+        auto parsing_result = ConvertValue(value_string);
+
+        if (!parsing_result.has_value()) {
+            value_status_ = ArgumentStatus::kInvalidArgument;
+            return std::unexpected(ParsingError{argv[position], ParsingErrorType::kInvalidArgument, long_name_, GetChoices()});
+        }
+
+        if constexpr (std::totally_ordered<T>) {
+            if (range_.has_value() && (*parsing_result < range_->first || range_->second < *parsing_result)) {
+                value_status_ = ArgumentStatus::kInvalidArgument;
+                return std::unexpected(ParsingError{argv[position], ParsingErrorType::kOutOfRange, long_name_});
+            }
+        }
+
+        conversion_timer.Stop();
+        AcceptValue(std::move(*parsing_result));
+    }
+
+    UpdateValueStatus();
+
+    return current_used_positions;
+}
+
+template <typename T>
+std::expected<size_t, ParsingError> SpecificArgument<T>::ParseTuple(std::span<const std::string_view> argv,
+                                                                    size_t position) requires TupleValue<T> {
+    using Traits = TupleTraits<T>;
+
+    // "--point=X Y Z" and "-pX Y Z" have the first element in the option token
+    std::string_view option = argv[position];
+    bool is_long = option.starts_with("--");
+    std::string_view name = option.substr(is_long ? 2 : 1);
+    size_t equal_sign_index = name.find('=');
+    std::optional<std::string_view> first_element;
+
+    if (equal_sign_index != std::string_view::npos) {
+        first_element = name.substr(equal_sign_index + 1);
+    } else if (!is_long && name.length() > 1) {
+        first_element = name.substr(1);
+    }
+
+    size_t following_tokens = Traits::kArity - (first_element.has_value() ? 1 : 0);
+
+    if (argv.size() - position - 1 < following_tokens) {
+        value_status_ = ArgumentStatus::kInsufficient;
+        return std::unexpected(ParsingError{argv[position], ParsingErrorType::kInsufficent, long_name_});
+    }
+
+    PhaseTimer conversion_timer(observer_, ParsePhase::kValueConversion, long_name_, GetType());
+    conversion_timer.SetCount(Traits::kArity);
+
+    T value{};
+    size_t token_position = first_element.has_value() ? position : position + 1;
+
+    for (size_t i = 0; i < Traits::kArity; ++i, ++token_position) {
+        std::string_view element_string = (i == 0 && first_element.has_value()) ? *first_element : argv[token_position];
+        std::optional<typename Traits::ElementType> element = ParseValue<typename Traits::ElementType>(element_string);
+
+        if (!element.has_value()) {
+            value_status_ = ArgumentStatus::kInvalidArgument;
+            return std::unexpected(ParsingError{argv[token_position], ParsingErrorType::kInvalidArgument, long_name_});
+        }
+
+        Traits::Get(value, i) = std::move(*element);
+    }
+
+    conversion_timer.Stop();
+
+    // The tuples of the repeated occurrences are stored one after another in a single buffer
+    AcceptValue(std::move(value));
+    UpdateValueStatus();
+
+    return following_tokens + 1;
+}
+
+template <typename T>
+bool SpecificArgument<T>::IsGlob() const {
+    return is_glob_;
+}
+
+template <typename T>
+std::expected<size_t, ParsingError> SpecificArgument<T>::ParseGlob(std::string_view pattern, GlobExpander& expander) {
+    if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>) {
+        PhaseTimer conversion_timer(observer_, ParsePhase::kValueConversion, long_name_, GetType());
+        std::vector<std::string>& matches = expander.Expand(pattern);
+        conversion_timer.SetCount(matches.size());
+
+        if (matches.empty()) {
+            value_status_ = ArgumentStatus::kInvalidArgument;
+            return std::unexpected(ParsingError{pattern, ParsingErrorType::kNoGlobMatch, long_name_});
+        }
+
+        // A single value argument can't hold the other matches
+        if (!is_multi_value_ && matches.size() > 1) {
+            value_status_ = ArgumentStatus::kInvalidArgument;
+            return std::unexpected(ParsingError{pattern, ParsingErrorType::kInvalidArgument, long_name_});
+        }
+
+        // The paths come from the file system, so they are stored without a conversion
+        for (std::string& match : matches) {
+            if (validate_utf8_ && !IsValidUtf8(match)) {
+                value_status_ = ArgumentStatus::kInvalidArgument;
+                return std::unexpected(ParsingError{pattern, ParsingErrorType::kInvalidArgument, long_name_});
+            }
+
+            AcceptValue(T(std::move(match)));
+        }
+
+        UpdateValueStatus();
+
+        return matches.size();
+    } else {
+        return std::unexpected(ParsingError{pattern, ParsingErrorType::kInvalidArgument, long_name_});
+    }
+}
 
-    store_values_to_->push_back(value_);
+template <typename T>
+void SpecificArgument<T>::AcceptValue(T&& value) {
     ++values_set_;
 
-    if (has_store_value_) {
-        *store_value_to_ = value_;
+    if constexpr (std::is_same_v<bool, T>) {
+        flag_.store->Set(flag_.bit);
+        flag_.AssignTarget(value);
+
+        if (has_store_value_) {
+            *store_value_to_ = value;
+        }
+
+        if (store_values_to_ != nullptr) {
+            store_values_to_->push_back(value);
+        }
+    } else if (is_bound_) {
+        *store_value_to_ = std::move(value);
+    } else {
+        // The value is moved into the storage and copied only to the variable from StoreValue()
+        StoreParsedValue(std::move(value));
+
+        if (has_store_value_) {
+            *store_value_to_ = GetStoredValue(GetStoredValuesCount() - 1);
+        }
     }
+}
 
+template <typename T>
+void SpecificArgument<T>::UpdateValueStatus() {
     if (values_set_ < minimum_values_ && !has_default_) {
         value_status_ = ArgumentStatus::kInsufficient;
     } else {
         value_status_ = ArgumentStatus::kSuccess;
     }
+}
 
-    return current_used_positions;
+template <typename T>
+std::optional<T> SpecificArgument<T>::ConvertValue(std::string_view value_string) const {
+    if (choices_.has_value()) {
+        return choices_->Find(value_string);
+    }
+
+    if constexpr (std::is_enum_v<T> || TupleValue<T>) {
+        return std::nullopt;
+    } else {
+        return ParseValue<T>(value_string);
+    }
+}
+
+template <typename T>
+void SpecificArgument<T>::StoreParsedValue(T&& value) {
+    if (store_values_to_ != nullptr) {
+        store_values_to_->push_back(std::move(value));
+        return;
+    }
+
+    if (!is_multi_value_ && values_.empty()) {
+        if (!inline_value_.has_value()) {
+            inline_value_.emplace(std::move(value));
+            return;
+        }
+
+        values_.push_back(std::move(*inline_value_));
+        inline_value_.reset();
+    }
+
+    values_.push_back(std::move(value));
+}
+
+template <typename T>
+T& SpecificArgument<T>::GetAccumulatedValue() {
+    // The first value of a parse is added to a copy of the default one
+    if (IsStoredInTarget()) {
+        return *store_value_to_;
+    }
+
+    if (store_values_to_ != nullptr) {
+        if (store_values_to_->empty()) {
+            store_values_to_->push_back(default_value_);
+        }
+
+        return store_values_to_->back();
+    }
+
+    if (!inline_value_.has_value()) {
+        inline_value_.emplace(default_value_);
+    }
+
+    return *inline_value_;
+}
+
+template <typename T>
+size_t SpecificArgument<T>::GetStoredValuesCount() const {
+    if (IsStoredInTarget()) {
+        return (values_set_ > 0) ? 1 : 0;
+    }
+
+    if (store_values_to_ != nullptr) {
+        return store_values_to_->size();
+    }
+
+    return inline_value_.has_value() ? 1 : values_.size();
 }
 
 template <typename T>
-SpecificArgument<T>::~SpecificArgument() {
-    if (was_temp_vector_created_) {
-        delete store_values_to_;
+const T& SpecificArgument<T>::GetStoredValue(size_t index) const {
+    if (IsStoredInTarget()) {
+        return *store_value_to_;
     }
+
+    if (store_values_to_ != nullptr) {
+        return (*store_values_to_)[index];
+    }
+
+    return inline_value_.has_value() ? *inline_value_ : values_[index];
 }
 
 template<typename T>
 std::optional<T> SpecificArgument<T>::GetValue(size_t index) const {
-    if (is_multi_value_ && has_default_ && index >= store_values_to_->size()) {
-        return default_value_;
+    if constexpr (std::is_same_v<bool, T>) {
+        return flag_.store->Test(flag_.bit) || default_value_;
+    } else {
+        size_t values_count = GetStoredValuesCount();
+
+        if (is_multi_value_ && has_default_ && index >= values_count) {
+            return default_value_;
+        }
+
+        if (values_count == 0 && has_default_) {
+            return default_value_;
+        }
+
+        if (index >= values_count) {
+            return std::nullopt;
+        }
+
+        return GetStoredValue(index);
     }
+}
 
-    if (store_values_to_->size() == 0 && has_default_) {
-        return default_value_;
+template<typename T>
+std::span<const T> SpecificArgument<T>::GetValues() const requires (!std::is_same_v<T, bool>) {
+    if (IsStoredInTarget()) {
+        return {store_value_to_, GetStoredValuesCount()};
     }
 
-    if (index >= store_values_to_->size()) {
-        return std::nullopt;
+    if (store_values_to_ != nullptr) {
+        return *store_values_to_;
     }
 
-    return store_values_to_->at(index);
+    if (inline_value_.has_value()) {
+        return {&*inline_value_, 1};
+    }
+
+    return values_;
+}
+
+template<typename T>
+std::vector<T> SpecificArgument<T>::TakeValues() requires (!std::is_same_v<T, bool>) {
+    std::vector<T> result;
+
+    if (IsStoredInTarget()) {
+        if (values_set_ > 0) {
+            result.push_back(std::move(*store_value_to_));
+        }
+    } else if (store_values_to_ != nullptr) {
+        result.swap(*store_values_to_);
+    } else if (inline_value_.has_value()) {
+        result.push_back(std::move(*inline_value_));
+        inline_value_.reset();
+    } else {
+        // The storage belongs to the parser's memory resource, so the elements are moved
+        result.reserve(values_.size());
+        std::move(values_.begin(), values_.end(), std::back_inserter(result));
+        values_.clear();
+    }
+
+    return result;
+}
+
+template<typename T>
+ArgHandle<T> SpecificArgument<T>::Handle() const {
+    return ArgHandle<T>(index_, generation_);
+}
+
+template<typename T>
+void SpecificArgument<T>::SetIndex(size_t index, uint64_t generation) {
+    index_ = index;
+    generation_ = generation;
 }
 
 template <typename T>
 void SpecificArgument<T>::Clear() {
-    store_values_to_->clear();
+    if (store_values_to_ != nullptr) {
+        store_values_to_->clear();
+    }
+
+    inline_value_.reset();
+    values_.clear();
     values_set_ = 0;
 
+    if constexpr (std::is_same_v<T, std::filesystem::path>) {
+        path_checks_.metadata.clear();
+    }
+
     value_status_ = has_default_ ? ArgumentStatus::kSuccess : ArgumentStatus::kNoArgument;
 
     if (has_store_value_) {
         *store_value_to_ = default_value_;
     }
+
+    if constexpr (std::is_same_v<bool, T>) {
+        flag_.AssignTarget(default_value_);
+    }
 }
 
-template<typename T>
-SpecificArgument<T>& SpecificArgument<T>::Default(T default_value) {
-    if (!was_default_value_string_set_) {
-        std::ostringstream stream;
-        stream << default_value;
-        default_value_string_ = stream.str();
-        
-        if (std::is_same_v<bool, T>) {
-            default_value_string_ = (default_value_string_ == "1") ? "true" : "false";
+template <typename T>
+void SpecificArgument<T>::AddPathChecks(PathCheckBatch& batch) {
+    if constexpr (std::is_same_v<T, std::filesystem::path>) {
+        if (path_checks_.requirements.IsEmpty()) {
+            return;
+        }
+
+        // The default value isn't checked, only the values from the command line
+        size_t values_count = (values_set_ > 0) ? GetStoredValuesCount() : 0;
+        path_checks_.first_result = batch.Size();
+
+        for (size_t i = 0; i < values_count; ++i) {
+            batch.Add(GetStoredValue(i));
+        }
+    }
+}
+
+template <typename T>
+std::expected<void, ParsingError> SpecificArgument<T>::TakePathChecks(const PathCheckBatch& batch,
+                                                                     const UserCredentials& credentials) {
+    if constexpr (std::is_same_v<T, std::filesystem::path>) {
+        if (path_checks_.requirements.IsEmpty()) {
+            return {};
+        }
+
+        size_t values_count = (values_set_ > 0) ? GetStoredValuesCount() : 0;
+        std::span<const PathMetadata> results = batch.GetResults().subspan(path_checks_.first_result, values_count);
+        path_checks_.metadata.assign(results.begin(), results.end());
+
+        for (size_t i = 0; i < values_count; ++i) {
+            if (!path_checks_.requirements.IsSatisfied(results[i], credentials)) {
+                value_status_ = ArgumentStatus::kInvalidArgument;
+                return std::unexpected(ParsingError{GetStoredValue(i).native(), ParsingErrorType::kInvalidPath, long_name_});
+            }
         }
     }
 
+    return {};
+}
+
+template <typename T>
+void SpecificArgument<T>::SetObserver(ParseObserver* observer) {
+    observer_ = observer;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Default(T default_value) {
     default_value_ = default_value;
     has_default_ = true;
+    is_default_value_string_valid_ = false;
     value_status_ = ArgumentStatus::kSuccess;
     return *this;
 }
@@ -233,7 +699,7 @@ SpecificArgument<T>& SpecificArgument<T>::MultiValue(size_t min_values) {
 }
 
 template<typename T>
-SpecificArgument<T>& SpecificArgument<T>::Positional() {
+SpecificArgument<T>& SpecificArgument<T>::Positional() requires (!TupleValue<T>) {
     is_positional_ = true;
     return *this;
 }
@@ -246,17 +712,116 @@ SpecificArgument<T>& SpecificArgument<T>::StoreValue(T& to) {
 }
 
 template<typename T>
-SpecificArgument<T>& SpecificArgument<T>::StoreValues(std::vector<T>& to) {
-    if (was_temp_vector_created_) {
-        delete store_values_to_;
-        was_temp_vector_created_ = false;
-    }
+template<size_t N>
+SpecificArgument<T>& SpecificArgument<T>::StoreValue(std::bitset<N>& to, size_t position)
+    requires std::is_same_v<T, bool> {
+    flag_.BindTarget(to, position);
+    return *this;
+}
+
+template<typename T>
+void SpecificArgument<T>::SetFlagStore(FlagStore* store, size_t bit) requires std::is_same_v<T, bool> {
+    flag_.store = store;
+    flag_.bit = bit;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Bind(T& field) {
+    Default(field);
+    StoreValue(field);
+    is_bound_ = true;
+    return *this;
+}
 
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::StoreValues(std::vector<T>& to) {
     store_values_to_ = &to;
     has_store_values_ = true;
     return *this;
 }
 
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Choices(std::initializer_list<std::pair<std::string_view, T>> choices) {
+    choices_.emplace(choices, schema_memory_);
+    is_default_value_string_valid_ = false;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Range(T min_value, T max_value) requires std::totally_ordered<T> {
+    range_.emplace(std::move(min_value), std::move(max_value));
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::ValidateUtf8() requires (std::is_same_v<T, std::string> || AccumulatedValue<T>) {
+    validate_utf8_ = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::MustExist() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.must_exist = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::IsDirectory() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.is_directory = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::IsRegularFile() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.is_regular_file = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Readable() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.is_readable = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Writable() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.is_writable = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Executable() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.is_executable = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::Glob()
+    requires (std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>) {
+    is_glob_ = true;
+    return *this;
+}
+
+template<typename T>
+SpecificArgument<T>& SpecificArgument<T>::WithMetadata() requires std::is_same_v<T, std::filesystem::path> {
+    path_checks_.requirements.collect_metadata = true;
+    return *this;
+}
+
+template<typename T>
+std::span<const PathMetadata> SpecificArgument<T>::GetMetadata() const requires std::is_same_v<T, std::filesystem::path> {
+    return path_checks_.metadata;
+}
+
+template <typename T>
+std::span<const std::string_view> SpecificArgument<T>::GetChoices() const {
+    if (!choices_.has_value()) {
+        return {};
+    }
+
+    return choices_->GetNames();
+}
+
 template <typename T>
 size_t SpecificArgument<T>::GetValuesSet() const {
     return values_set_;
@@ -267,13 +832,52 @@ std::string_view SpecificArgument<T>::GetType() const {
     return typeid(T).name();
 }
 
+template <typename T>
+size_t SpecificArgument<T>::GetArity() const {
+    if constexpr (TupleValue<T>) {
+        return TupleTraits<T>::kArity;
+    } else {
+        return 1;
+    }
+}
+
+template <typename T>
+std::string_view SpecificArgument<T>::GetElementType() const {
+    if constexpr (TupleValue<T>) {
+        return typeid(typename TupleTraits<T>::ElementType).name();
+    } else {
+        return GetType();
+    }
+}
+
 template <typename T>
 ArgumentStatus SpecificArgument<T>::GetValueStatus() const {
     return value_status_;
 }
 
 template <typename T>
-const std::string& SpecificArgument<T>::GetDefaultValueString() const {
+std::string_view SpecificArgument<T>::GetDefaultValueString() const {
+    if (was_default_value_string_set_ || is_default_value_string_valid_ || !has_default_) {
+        return default_value_string_;
+    }
+
+    std::optional<std::string_view> choice_name;
+
+    // The function is virtual, so it's instantiated for every type, including the ones without operator==
+    if constexpr (std::equality_comparable<T>) {
+        if (choices_.has_value()) {
+            choice_name = choices_->GetName(default_value_);
+        }
+    }
+
+    // Enumerations are printed only by the name of the choice
+    if (choice_name.has_value()) {
+        default_value_string_ = choice_name.value();
+    } else if constexpr (!std::is_enum_v<T>) {
+        default_value_string_ = FormatValue(default_value_);
+    }
+
+    is_default_value_string_valid_ = true;
     return default_value_string_;
 }
 
@@ -284,12 +888,12 @@ void SpecificArgument<T>::SetDefaultValueString(const std::string& str) {
 }
 
 template <typename T>
-const std::string& SpecificArgument<T>::GetDescription() const {
+std::string_view SpecificArgument<T>::GetDescription() const {
     return description_;
 }
 
 template <typename T>
-const std::string& SpecificArgument<T>::GetLongName() const {
+std::string_view SpecificArgument<T>::GetLongName() const {
     return long_name_;
 }
 
@@ -323,4 +927,36 @@ bool SpecificArgument<T>::IsFlag() const {
     return is_flag_;
 }
 
+template <typename T>
+size_t SpecificArgument<T>::GetValuesMemoryUsage() const {
+    return values_memory_.GetBytes();
+}
+
+template <typename T>
+bool SpecificArgument<T>::HasSameValues(const Argument& other) const {
+    auto* other_argument = dynamic_cast<const SpecificArgument<T>*>(&other);
+
+    if (other_argument == nullptr || GetValuesSet() != other_argument->GetValuesSet()) {
+        return false;
+    }
+
+    // Values which can't be compared are considered changed
+    if constexpr (std::equality_comparable<T>) {
+        for (size_t i = 0; i < std::max<size_t>(GetValuesSet(), 1); ++i) {
+            if (GetValue(i) != other_argument->GetValue(i)) {
+                return false;
+            }
+        }
+
+        return true;
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+void SpecificArgument<T>::Destroy(std::pmr::memory_resource* memory) {
+    std::pmr::polymorphic_allocator<>(memory).delete_object(this);
+}
+
 } // namespace ArgumentParser
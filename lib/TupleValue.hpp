@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+
+namespace ArgumentParser {
+
+// A value made of a fixed number of tokens, like "--bbox x0 y0 x1 y1".
+// std::array<T, N> is supported, and a user aggregate may be registered by a specialization:
+//     template<>
+//     struct ArgumentParser::TupleTraits<Point> {
+//         using ElementType = double;
+//         static constexpr size_t kArity = 3;
+//         static double& Get(Point& point, size_t index) { ... }
+//     };
+// The elements are converted by ParseValue<ElementType>.
+template<typename T>
+struct TupleTraits {};
+
+template<typename Element, size_t N>
+struct TupleTraits<std::array<Element, N>> {
+    using ElementType = Element;
+    static constexpr size_t kArity = N;
+
+    static Element& Get(std::array<Element, N>& value, size_t index) {
+        return value[index];
+    }
+};
+
+template<typename T>
+concept TupleValue = requires(T& value, size_t index) {
+    typename TupleTraits<T>::ElementType;
+    { TupleTraits<T>::kArity } -> std::convertible_to<size_t>;
+    { TupleTraits<T>::Get(value, index) } -> std::same_as<typename TupleTraits<T>::ElementType&>;
+} && TupleTraits<T>::kArity > 0;
+
+} // namespace ArgumentParser
@@ -0,0 +1,290 @@
+#include "Utf8.hpp"
+#include "utils/utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace ArgumentParser {
+
+ARGPARSER_INLINE bool IsValidUtf8Scalar(std::string_view text) {
+    const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+    size_t size = text.size();
+    size_t i = 0;
+
+    while (i < size) {
+        // ASCII is skipped by 8 bytes
+        if (i + 8 <= size) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned char lead = data[i];
+
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+
+        size_t length = 0;
+        unsigned char second_min = 0x80;
+        unsigned char second_max = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            second_min = (lead == 0xE0) ? 0xA0 : 0x80;
+            second_max = (lead == 0xED) ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            second_min = (lead == 0xF0) ? 0x90 : 0x80;
+            second_max = (lead == 0xF4) ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+
+        if (i + length > size || data[i + 1] < second_min || data[i + 1] > second_max) {
+            return false;
+        }
+
+        for (size_t j = 2; j < length; ++j) {
+            if ((data[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+
+        i += length;
+    }
+
+    return true;
+}
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+
+namespace Utf8Tables {
+
+// Every bit is an error which a pair of bytes may have, see "Validating UTF-8 In Less Than One Instruction Per Byte"
+inline constexpr uint8_t kTooShort = 1 << 0;
+inline constexpr uint8_t kTooLong = 1 << 1;
+inline constexpr uint8_t kOverlong3 = 1 << 2;
+inline constexpr uint8_t kTooLarge = 1 << 3;
+inline constexpr uint8_t kSurrogate = 1 << 4;
+inline constexpr uint8_t kOverlong2 = 1 << 5;
+inline constexpr uint8_t kTooLarge1000 = 1 << 6;
+inline constexpr uint8_t kOverlong4 = 1 << 6;
+inline constexpr uint8_t kTwoContinuations = 1 << 7;
+inline constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+// Indexed by the high nibble of the previous byte
+alignas(16) inline constexpr uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoContinuations, kTwoContinuations, kTwoContinuations, kTwoContinuations,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+// Indexed by the low nibble of the previous byte
+alignas(16) inline constexpr uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// Indexed by the high nibble of the current byte
+alignas(16) inline constexpr uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+
+// A block is incomplete if one of its last three bytes starts a sequence longer than the rest of the block
+alignas(32) inline constexpr uint8_t kIncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+} // namespace Utf8Tables
+
+ARGPARSER_INLINE bool CpuSupportsSse4() {
+    return __builtin_cpu_supports("sse4.1");
+}
+
+ARGPARSER_INLINE bool CpuSupportsAvx2() {
+    return __builtin_cpu_supports("avx2");
+}
+
+struct Utf8StateSse4 {
+    __m128i error;
+    __m128i prev_input;
+    __m128i prev_incomplete;
+};
+
+__attribute__((target("sse4.1"))) static void CheckUtf8BlockSse4(__m128i input, Utf8StateSse4& state) {
+    if (_mm_movemask_epi8(input) == 0) {
+        // An ASCII block can't continue a sequence of the previous one
+        state.error = _mm_or_si128(state.error, state.prev_incomplete);
+    } else {
+        const __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+        __m128i prev1 = _mm_alignr_epi8(input, state.prev_input, 15);
+        __m128i prev2 = _mm_alignr_epi8(input, state.prev_input, 14);
+        __m128i prev3 = _mm_alignr_epi8(input, state.prev_input, 13);
+
+        __m128i byte_1_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte1High)),
+                                               _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble_mask));
+        __m128i byte_1_low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte1Low)),
+                                              _mm_and_si128(prev1, low_nibble_mask));
+        __m128i byte_2_high = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte2High)),
+                                               _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble_mask));
+        __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+        // The third and the fourth bytes of a sequence must be continuations
+        __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80));
+        __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80));
+        __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte),
+                                                     _mm_set1_epi8(static_cast<char>(0x80)));
+
+        state.error = _mm_or_si128(state.error, _mm_xor_si128(must_be_continuation, special_cases));
+        state.prev_incomplete = _mm_subs_epu8(input,
+            _mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kIncompleteMax + 16)));
+    }
+
+    state.prev_input = input;
+}
+
+__attribute__((target("sse4.1"))) ARGPARSER_INLINE bool IsValidUtf8Sse4(std::string_view text) {
+    constexpr size_t kBlockSize = 16;
+
+    Utf8StateSse4 state{_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    size_t i = 0;
+
+    for (; i + kBlockSize <= text.size(); i += kBlockSize) {
+        CheckUtf8BlockSse4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i)), state);
+    }
+
+    if (i < text.size()) {
+        // The tail is padded with zeros, which are ASCII
+        alignas(16) char tail[kBlockSize] = {};
+        std::memcpy(tail, text.data() + i, text.size() - i);
+        CheckUtf8BlockSse4(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)), state);
+    }
+
+    state.error = _mm_or_si128(state.error, state.prev_incomplete);
+
+    return _mm_testz_si128(state.error, state.error) != 0;
+}
+
+struct Utf8StateAvx2 {
+    __m256i error;
+    __m256i prev_input;
+    __m256i prev_incomplete;
+};
+
+__attribute__((target("avx2"))) static void CheckUtf8BlockAvx2(__m256i input, Utf8StateAvx2& state) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+    } else {
+        const __m256i low_nibble_mask = _mm256_set1_epi8(0x0F);
+
+        // The bytes preceding the block's lanes: [previous high lane, current low lane]
+        __m256i shifted = _mm256_permute2x128_si256(state.prev_input, input, 0x21);
+        __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+        __m256i prev2 = _mm256_alignr_epi8(input, shifted, 14);
+        __m256i prev3 = _mm256_alignr_epi8(input, shifted, 13);
+
+        // The shuffles work within the lanes, so both lanes hold the same table
+        __m256i byte_1_high_table = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte1High)));
+        __m256i byte_1_low_table = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte1Low)));
+        __m256i byte_2_high_table = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(Utf8Tables::kByte2High)));
+
+        __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table,
+                                                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask));
+        __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, low_nibble_mask));
+        __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table,
+                                                  _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble_mask));
+        __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+        __m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+        __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+        __m256i must_be_continuation = _mm256_and_si256(_mm256_or_si256(is_third_byte, is_fourth_byte),
+                                                        _mm256_set1_epi8(static_cast<char>(0x80)));
+
+        state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_be_continuation, special_cases));
+        state.prev_incomplete = _mm256_subs_epu8(input,
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(Utf8Tables::kIncompleteMax)));
+    }
+
+    state.prev_input = input;
+}
+
+__attribute__((target("avx2"))) ARGPARSER_INLINE bool IsValidUtf8Avx2(std::string_view text) {
+    constexpr size_t kBlockSize = 32;
+
+    Utf8StateAvx2 state{_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    size_t i = 0;
+
+    for (; i + kBlockSize <= text.size(); i += kBlockSize) {
+        CheckUtf8BlockAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i)), state);
+    }
+
+    if (i < text.size()) {
+        alignas(32) char tail[kBlockSize] = {};
+        std::memcpy(tail, text.data() + i, text.size() - i);
+        CheckUtf8BlockAvx2(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)), state);
+    }
+
+    state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+
+    return _mm256_testz_si256(state.error, state.error) != 0;
+}
+
+#endif
+
+ARGPARSER_INLINE bool IsValidUtf8(std::string_view text) {
+    // Short tokens are checked faster than a block is set up
+    if (text.size() < 16) {
+        return IsValidUtf8Scalar(text);
+    }
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+    static bool (*const validate)(std::string_view) = CpuSupportsAvx2() ? &IsValidUtf8Avx2
+                                                    : CpuSupportsSse4() ? &IsValidUtf8Sse4
+                                                                        : &IsValidUtf8Scalar;
+
+    return validate(text);
+#else
+    return IsValidUtf8Scalar(text);
+#endif
+}
+
+} // namespace ArgumentParser
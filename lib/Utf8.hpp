@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ARGPARSER_HAS_X86_SIMD
+#endif
+
+namespace ArgumentParser {
+
+// Checks that the text is well-formed UTF-8: no overlong forms, surrogates,
+// code points above U+10FFFF or truncated sequences.
+// The fastest validator supported by the CPU is chosen on the first call.
+bool IsValidUtf8(std::string_view text);
+
+bool IsValidUtf8Scalar(std::string_view text);
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+// The lookup algorithm of Keiser and Lemire over 16 and 32 byte blocks.
+// They may be called only if the CPU supports the instructions
+bool IsValidUtf8Sse4(std::string_view text);
+bool IsValidUtf8Avx2(std::string_view text);
+
+bool CpuSupportsSse4();
+bool CpuSupportsAvx2();
+#endif
+
+} // namespace ArgumentParser
+
+#ifdef ARGPARSER_HEADER_ONLY
+#include "Utf8.cpp"
+#endif
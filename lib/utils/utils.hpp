@@ -2,13 +2,32 @@
 
 #include <expected>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <charconv>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// std::from_chars for integers is constexpr since C++23, but not every standard library provides it yet
+#if defined(__cpp_lib_constexpr_charconv) && __cpp_lib_constexpr_charconv >= 202207L
+#define ARGPARSER_CONSTEXPR_CHARCONV constexpr
+#else
+#define ARGPARSER_CONSTEXPR_CHARCONV inline
+#endif
+
+// In the header-only mode the sources are included into every translation unit
+#ifdef ARGPARSER_HEADER_ONLY
+#define ARGPARSER_INLINE inline
+#else
+#define ARGPARSER_INLINE
+#endif
 
 namespace ArgumentParser {
 
 template<typename T>
-std::expected<T, std::string> ParseNumber(std::string_view str) {
+ARGPARSER_CONSTEXPR_CHARCONV std::expected<T, std::string> ParseNumber(std::string_view str) {
     T result;
     std::from_chars_result convertion_result = std::from_chars(str.data(), str.data() + str.size(), result);
 
@@ -21,4 +40,119 @@ std::expected<T, std::string> ParseNumber(std::string_view str) {
     return result;
 }
 
+// Levenshtein distance from a fixed pattern to many texts.
+// Patterns up to 64 characters use the bit-parallel algorithm of Myers in Hyyro's formulation,
+// longer ones fall back to the banded dynamic programming.
+class EditDistanceMatcher {
+public:
+    explicit EditDistanceMatcher(std::string_view pattern) : pattern_(pattern) {
+        if (pattern_.length() > 64) {
+            return;
+        }
+
+        for (size_t i = 0; i < pattern_.length(); ++i) {
+            peq_[static_cast<unsigned char>(pattern_[i])] |= uint64_t{1} << i;
+        }
+    }
+
+    std::optional<size_t> Distance(std::string_view text, size_t max_distance) const {
+        size_t length_difference = (text.length() > pattern_.length())
+            ? text.length() - pattern_.length()
+            : pattern_.length() - text.length();
+
+        if (length_difference > max_distance) {
+            return std::nullopt;
+        }
+
+        if (pattern_.empty()) {
+            return text.length();
+        }
+
+        if (pattern_.length() > 64) {
+            return BandedDistance(text, max_distance);
+        }
+
+        uint64_t positive_vertical = ~uint64_t{0};
+        uint64_t negative_vertical = 0;
+        uint64_t last_bit = uint64_t{1} << (pattern_.length() - 1);
+        size_t score = pattern_.length();
+
+        for (size_t j = 0; j < text.length(); ++j) {
+            uint64_t equal = peq_[static_cast<unsigned char>(text[j])];
+            uint64_t vertical = equal | negative_vertical;
+            uint64_t horizontal = (((equal & positive_vertical) + positive_vertical) ^ positive_vertical) | equal;
+
+            uint64_t positive_horizontal = negative_vertical | ~(horizontal | positive_vertical);
+            uint64_t negative_horizontal = positive_vertical & horizontal;
+
+            if (positive_horizontal & last_bit) {
+                ++score;
+            } else if (negative_horizontal & last_bit) {
+                --score;
+            }
+
+            // Every remaining character can lower the score by at most one
+            if (score > max_distance + (text.length() - j - 1)) {
+                return std::nullopt;
+            }
+
+            positive_horizontal = (positive_horizontal << 1) | 1;
+            negative_horizontal <<= 1;
+
+            positive_vertical = negative_horizontal | ~(vertical | positive_horizontal);
+            negative_vertical = positive_horizontal & vertical;
+        }
+
+        if (score > max_distance) {
+            return std::nullopt;
+        }
+
+        return score;
+    }
+
+private:
+    std::string_view pattern_;
+    std::array<uint64_t, 256> peq_{};
+
+    std::optional<size_t> BandedDistance(std::string_view text, size_t max_distance) const {
+        const size_t kInfinity = max_distance + 1;
+
+        std::vector<size_t> previous(text.length() + 1);
+        std::vector<size_t> current(text.length() + 1);
+
+        for (size_t j = 0; j <= text.length(); ++j) {
+            previous[j] = std::min(j, kInfinity);
+        }
+
+        for (size_t i = 1; i <= pattern_.length(); ++i) {
+            size_t first = (i > max_distance) ? i - max_distance : 1;
+            size_t last = std::min(text.length(), i + max_distance);
+            std::fill(current.begin(), current.end(), kInfinity);
+            current[0] = std::min(i, kInfinity);
+
+            size_t row_minimum = current[0];
+
+            for (size_t j = first; j <= last; ++j) {
+                size_t substitution = previous[j - 1] + (pattern_[i - 1] == text[j - 1] ? 0 : 1);
+                size_t value = std::min({substitution, previous[j] + 1, current[j - 1] + 1, kInfinity});
+
+                current[j] = value;
+                row_minimum = std::min(row_minimum, value);
+            }
+
+            if (row_minimum > max_distance) {
+                return std::nullopt;
+            }
+
+            std::swap(previous, current);
+        }
+
+        if (previous[text.length()] > max_distance) {
+            return std::nullopt;
+        }
+
+        return previous[text.length()];
+    }
+};
+
 } // namespace ArgumentParser
@@ -0,0 +1,134 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <gtest/gtest.h>
+#include "lib/ArgParser.hpp"
+
+using namespace ArgumentParser;
+
+/*
+    The global operator new/delete are replaced to count
+    the allocations performed by a single Parse call
+*/
+namespace {
+
+std::atomic<bool> is_counting = false;
+std::atomic<size_t> allocations_count = 0;
+
+void* CountedAllocate(std::size_t size) {
+    if (is_counting) {
+        ++allocations_count;
+    }
+
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc{};
+}
+
+template<typename Function>
+size_t CountAllocations(Function function) {
+    allocations_count = 0;
+    is_counting = true;
+    function();
+    is_counting = false;
+
+    return allocations_count;
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+
+TEST(ArgParserAllocationTestSuite, SteadyStateParseTest) {
+    ArgParser parser("My Parser");
+    std::vector<int> values;
+    int32_t number;
+    parser.AddHelp('h', "help", "Some Description about program");
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddFlag('g', "another-flag", "Another flag");
+    parser.AddIntArgument('n', "number", "Some Number").StoreValue(number);
+    parser.AddStringArgument('s', "str", "Some string").Default("default");
+    parser.AddDoubleArgument("ratio", "Some ratio").MultiValue().Default(1.5);
+    parser.AddIntArgument("Param1").MultiValue(1).Positional().StoreValues(values);
+
+    const char* argv[] = {"app", "-n", "10", "--str=short", "-fg", "--ratio", "2.5", "--ratio=3.5", "1", "2", "--", "-3"};
+
+    size_t first_parse_allocations = CountAllocations([&parser, &argv] {
+        ASSERT_TRUE(parser.Parse(std::span<const char* const>(argv)));
+    });
+
+    size_t allocations = CountAllocations([&parser, &argv] {
+        ASSERT_TRUE(parser.Parse(std::span<const char* const>(argv)));
+    });
+
+    ASSERT_GT(first_parse_allocations, 0);
+    ASSERT_EQ(allocations, 0);
+    ASSERT_EQ(number, 10);
+    ASSERT_EQ(values.size(), 3);
+    ASSERT_EQ(parser.GetStringValue("str"), "short");
+}
+
+
+TEST(ArgParserAllocationTestSuite, SteadyStateStringViewParseTest) {
+    ArgParser parser("My Parser");
+    parser.AllowAbbreviations();
+    parser.AddFlag('v', "verbose", "Verbose output");
+    parser.AddIntArgument('n', "number", "Some Number");
+
+    std::vector<std::string_view> argv = {"app", "--verb", "-n5"};
+
+    ASSERT_TRUE(parser.Parse(argv));
+
+    size_t allocations = CountAllocations([&parser, &argv] {
+        ASSERT_TRUE(parser.Parse(argv));
+    });
+
+    ASSERT_EQ(allocations, 0);
+    ASSERT_EQ(parser.GetIntValue("number"), 5);
+}
+
+
+TEST(ArgParserAllocationTestSuite, InlineSingleValueTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('n', "number", "Some Number");
+    parser.AddDoubleArgument("ratio", "Some ratio").Default(1.5);
+
+    std::vector<std::string_view> argv = {"app", "-n", "5", "--ratio=2.5"};
+    std::vector<std::string_view> other_argv = {"app", "--number=7"};
+
+    ASSERT_TRUE(parser.Parse(argv));
+
+    size_t allocations = CountAllocations([&parser, &other_argv] {
+        ASSERT_TRUE(parser.Parse(other_argv));
+    });
+
+    ASSERT_EQ(allocations, 0);
+    ASSERT_EQ(parser.GetIntValue("number"), 7);
+    ASSERT_EQ(parser.GetDoubleValue("ratio"), 1.5);
+}
@@ -0,0 +1,211 @@
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include "lib/ArgParser.hpp"
+
+#include "cli.hpp"
+#include "defaults.hpp"
+#include "many_options.hpp"
+#include "multi_value.hpp"
+#include "strings.hpp"
+
+using namespace ArgumentParser;
+
+/*
+    The scenarios of argparser_test.cpp for the parsers generated by argparser-gen
+    from the schemas in tests/schemas
+*/
+std::vector<std::string> SplitString(const std::string& str) {
+    std::istringstream iss(str);
+
+    return {std::istream_iterator<std::string>(iss), std::istream_iterator<std::string>()};
+}
+
+
+TEST(GeneratedParserTestSuite, StringTest) {
+    Strings::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --param1=value1")));
+    ASSERT_EQ(parser.GetOptions().param1, "value1");
+}
+
+
+TEST(GeneratedParserTestSuite, ShortNameTest) {
+    Strings::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p=value1")));
+    ASSERT_EQ(parser.GetOptions().param1, "value1");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p value2")));
+    ASSERT_EQ(parser.GetOptions().param1, "value2");
+}
+
+
+TEST(GeneratedParserTestSuite, NoDefaultTest) {
+    Strings::Parser parser;
+
+    ASSERT_FALSE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kNoArgument);
+    ASSERT_EQ(parser.GetError().argument_name, "param1");
+}
+
+
+TEST(GeneratedParserTestSuite, UnknownArgumentTest) {
+    Strings::Parser parser;
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param2=value")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kUnknownArgument);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=value positional")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kUnknownArgument);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInsufficent);
+}
+
+
+TEST(GeneratedParserTestSuite, DefaultTest) {
+    Defaults::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetOptions().param1, "value1");
+    ASSERT_EQ(parser.GetOptions().ratio, std::vector<double>{3.14});
+    ASSERT_EQ(parser.GetOptions().number, -42);
+    ASSERT_EQ(parser.GetOptions().level, 7);
+    ASSERT_EQ(parser.GetOptions().symbol, '\'');
+}
+
+
+TEST(GeneratedParserTestSuite, MultiValueWithDefaultTest) {
+    Defaults::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --ratio -4.2 -r=1.5")));
+    ASSERT_EQ(parser.GetOptions().ratio, (std::vector<double>{-4.2, 1.5}));
+    ASSERT_EQ(parser.GetValuesSet("ratio"), 2);
+    ASSERT_EQ(parser.GetValuesSet("other"), std::nullopt);
+}
+
+
+TEST(GeneratedParserTestSuite, MinCountMultiValueTest) {
+    MultiValue::Parser parser;
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --param1=1 --param1=2 --param1=3")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInsufficent);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -p1 -p2 -p3 -p4 -p5 -p6 -p7 -p8 -p9 -p10")));
+    ASSERT_EQ(parser.GetOptions().param1.size(), 10);
+    ASSERT_EQ(parser.GetOptions().param1[9], 10);
+}
+
+
+TEST(GeneratedParserTestSuite, FlagsTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -fc -n 1 2")));
+    ASSERT_TRUE(parser.GetOptions().flag);
+    ASSERT_TRUE(parser.GetOptions().flag2);
+    ASSERT_TRUE(parser.GetOptions().flag3);
+}
+
+
+TEST(GeneratedParserTestSuite, PositionalAndNormalArgTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 0 1 2 3 4 5 -f")));
+    ASSERT_TRUE(parser.GetOptions().flag);
+    ASSERT_FALSE(parser.GetOptions().flag3);
+    ASSERT_EQ(parser.GetOptions().number, 0);
+    ASSERT_EQ(parser.GetOptions().Param1, (std::vector<int32_t>{1, 2, 3, 4, 5}));
+}
+
+
+TEST(GeneratedParserTestSuite, PositionalNegativeNumbersTest) {
+    Cli::Parser parser;
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -n 0 1 2 3 -4 5 -f")));
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 0 1 2 3 -f -- -4 5")));
+    ASSERT_TRUE(parser.GetOptions().flag);
+    ASSERT_EQ(parser.GetOptions().Param1, (std::vector<int32_t>{1, 2, 3, -4, 5}));
+}
+
+
+TEST(GeneratedParserTestSuite, ShortArgWithNoEqualSignTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n1 -r-4.2 -itest.tsv 7")));
+    ASSERT_EQ(parser.GetOptions().ratio, -4.2);
+    ASSERT_EQ(parser.GetOptions().input, "test.tsv");
+}
+
+
+TEST(GeneratedParserTestSuite, FlagWithValueTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --flag -n 1 2")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --flag=YES -n 1 2")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+}
+
+
+TEST(GeneratedParserTestSuite, InvalidValueTest) {
+    Cli::Parser parser;
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ratio=helpmepls -n 1 2")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().argument_name, "ratio");
+}
+
+
+TEST(GeneratedParserTestSuite, RepeatedParsingTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 2 -f -i test 1")));
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 3 4")));
+    ASSERT_FALSE(parser.GetOptions().flag);
+    ASSERT_EQ(parser.GetOptions().number, 3);
+    ASSERT_EQ(parser.GetOptions().input, "input \"file\".txt");
+    ASSERT_EQ(parser.GetOptions().Param1, std::vector<int32_t>{4});
+}
+
+
+TEST(GeneratedParserTestSuite, HelpTest) {
+    Cli::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --help")));
+    ASSERT_TRUE(parser.Help());
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --help=helpmepls")));
+    ASSERT_FALSE(parser.Help());
+}
+
+
+TEST(GeneratedParserTestSuite, HelpStringTest) {
+    ArgParser parser("My Parser", "Some Description about program");
+    parser.AddHelp('h', "help", "Display this help and exit");
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddFlag('b', "flag2", "Use some logic").Default(true);
+    parser.AddFlag('c', "flag3");
+    parser.AddIntArgument('n', "number", "Some Number");
+    parser.AddDoubleArgument('r', "ratio", "I have no idea what this may be").Default(0.5);
+    parser.AddStringArgument('i', "input", "File path for input file").Default("input \"file\".txt");
+    parser.AddIntArgument("Param1", "Values").MultiValue(1).Positional();
+
+    ASSERT_EQ(Cli::Parser::HelpDescription(), parser.HelpDescription());
+}
+
+
+TEST(GeneratedParserTestSuite, PerfectHashTest) {
+    for (size_t index = 0; index < 2000; ++index) {
+        std::string name = "option-" + std::to_string(index);
+        ASSERT_EQ(ManyOptions::Parser::FindLongName(name), index);
+    }
+
+    ASSERT_EQ(ManyOptions::Parser::FindLongName("option-2000"), std::nullopt);
+    ASSERT_EQ(ManyOptions::Parser::FindLongName(""), std::nullopt);
+
+    ManyOptions::Parser parser;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --option-1999=5")));
+    ASSERT_EQ(parser.GetOptions().option_1999, 5);
+    ASSERT_EQ(parser.GetOptions().option_1998, 1998);
+}
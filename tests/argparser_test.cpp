@@ -1,8 +1,18 @@
 #include <sstream>
+#include <cstring>
 #include <fstream>
+#include <random>
+#include <thread>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 #include "lib/ArgParser.hpp"
+#include "lib/ConfigReloader.hpp"
+#include "lib/DefinedOption.hpp"
+#include "lib/Utf8.hpp"
 
 using namespace ArgumentParser;
 
@@ -134,6 +144,23 @@ TEST(ArgParserTestSuite, FlagsTest) {
 }
 
 
+TEST(ArgParserTestSuite, FlagStoreValuesTest) {
+    ArgParser parser("My Parser");
+    std::vector<bool> values;
+    parser.AddFlag('a', "aa").StoreValues(values);
+    parser.AddFlag('b', "bb");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -ab")));
+    ASSERT_EQ(values, std::vector<bool>{true});
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -b")));
+    ASSERT_TRUE(values.empty());
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --aa")));
+    ASSERT_EQ(values, std::vector<bool>{true});
+}
+
+
 TEST(ArgParserTestSuite, PositionalArgTest) {
     ArgParser parser("My Parser");
     std::vector<int> values;
@@ -221,6 +248,58 @@ TEST(ArgParserTestSuite, HelpStringTest) {
 }
 
 
+struct Celsius {
+    double degrees = 0;
+};
+
+std::ostream& operator<<(std::ostream& stream, const Celsius& value) {
+    return stream << value.degrees << "C";
+}
+
+template<>
+inline std::optional<Celsius> ArgumentParser::ParseValue<Celsius>(std::string_view value_string) {
+    std::optional<double> degrees = ParseValue<double>(value_string);
+    return degrees.has_value() ? std::optional<Celsius>(Celsius{*degrees}) : std::nullopt;
+}
+
+struct Unprintable {};
+
+template<>
+inline std::optional<Unprintable> ArgumentParser::ParseValue<Unprintable>(std::string_view) {
+    return Unprintable{};
+}
+
+
+TEST(ArgParserTestSuite, HelpDefaultValuesTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('s', "flag1", "Use some logic").Default(true);
+    parser.AddFlag('p', "flag2", "Use some logic");
+    parser.AddIntArgument("number", "Some Number").Default(-42);
+    parser.AddDoubleArgument("ratio", "Some ratio").Default(0.1);
+    parser.AddStringArgument("name", "Some name").Default("John");
+    parser.AddArgument<uint8_t>("level", "Some level").Default(7);
+
+    std::string help = parser.HelpDescription();
+    ASSERT_NE(help.find("Use some logic [default = true]"), std::string::npos);
+    ASSERT_NE(help.find("Use some logic [default = false]"), std::string::npos);
+    ASSERT_NE(help.find("[default = -42]"), std::string::npos);
+    ASSERT_NE(help.find("[default = 0.1]"), std::string::npos);
+    ASSERT_NE(help.find("[default = John]"), std::string::npos);
+    ASSERT_NE(help.find("[default = 7]"), std::string::npos);
+
+    // A user type is printed by its operator<<, and a default without a formatter is left out
+    parser.AddArgument<Celsius>("temperature", "Some temperature").Default(Celsius{36.6});
+    parser.AddArgument<Unprintable>("opaque", "Some value").Default(Unprintable{});
+
+    help = parser.HelpDescription();
+    ASSERT_NE(help.find("Some temperature [default = 36.6C]"), std::string::npos);
+    ASSERT_NE(help.find("Some value\n"), std::string::npos);
+
+    ASSERT_EQ(FormatValue(1e300), "1e+300");
+    ASSERT_EQ(FormatValue(uint64_t{18446744073709551615ULL}), "18446744073709551615");
+}
+
+
 TEST(ArgParserTestSuite, DoubleTest) {
     ArgParser parser("My Parser");
     double val;
@@ -349,3 +428,1449 @@ TEST(ArgParserTestSuite, EmptyValueTest) {
     ASSERT_FALSE(parser.Parse(SplitString("app -n")));
     ASSERT_FALSE(parser.Parse(SplitString("app --number")));
 }
+
+
+TEST(ArgParserTestSuite, AbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.AllowAbbreviations();
+    parser.AddFlag('v', "verbose", "Verbose output");
+    parser.AddIntArgument("number", "Some Number");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --verb --num=5")));
+    ASSERT_TRUE(parser.GetFlag("verbose"));
+    ASSERT_EQ(parser.GetIntValue("number"), 5);
+}
+
+
+TEST(ArgParserTestSuite, AmbiguousAbbreviationTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("verbose", "Verbose output");
+    parser.AddFlag("version", "Show version");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ver")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kUnknownArgument);
+
+    parser.AllowAbbreviations();
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ver")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kAmbiguousArgument);
+    ASSERT_EQ(parser.GetError().candidates.size(), 2);
+    ASSERT_EQ(parser.GetError().candidates[0], "verbose");
+    ASSERT_EQ(parser.GetError().candidates[1], "version");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --vers")));
+    ASSERT_TRUE(parser.GetFlag("version"));
+    ASSERT_FALSE(parser.GetFlag("verbose"));
+}
+
+
+TEST(ArgParserTestSuite, SuggestionsTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('v', "verbose", "Verbose output");
+    parser.AddFlag("version", "Show version");
+    parser.AddStringArgument('o', "output", "Output file");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --verbos")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kUnknownArgument);
+
+    std::vector<std::string_view> suggestions = parser.GetSuggestions(parser.GetError().argument_string);
+    ASSERT_EQ(suggestions.size(), 1);
+    ASSERT_EQ(suggestions[0], "verbose");
+
+    suggestions = parser.GetSuggestions("--verse", 3, 3);
+    ASSERT_EQ(suggestions.size(), 2);
+    ASSERT_EQ(suggestions[0], "verbose");
+    ASSERT_EQ(suggestions[1], "version");
+
+    ASSERT_EQ(parser.GetSuggestions("--outptu=file.txt").size(), 1);
+    ASSERT_TRUE(parser.GetSuggestions("--nothing-like-that").empty());
+}
+
+
+TEST(ArgParserTestSuite, SuggestionsLargeSchemaTest) {
+    ArgParser parser("My Parser");
+
+    for (size_t i = 0; i < 20000; ++i) {
+        parser.AddFlag("generated-option-" + std::to_string(i));
+    }
+
+    std::vector<std::string_view> suggestions = parser.GetSuggestions("--generated-optoin-12345", 1);
+    ASSERT_EQ(suggestions.size(), 1);
+    ASSERT_EQ(suggestions[0], "generated-option-12345");
+}
+
+
+TEST(ArgParserTestSuite, EditDistanceTest) {
+    auto naive_distance = [](std::string_view lhs, std::string_view rhs) {
+        std::vector<std::vector<size_t>> table(lhs.size() + 1, std::vector<size_t>(rhs.size() + 1));
+
+        for (size_t i = 0; i <= lhs.size(); ++i) {
+            for (size_t j = 0; j <= rhs.size(); ++j) {
+                if (i == 0 || j == 0) {
+                    table[i][j] = i + j;
+                    continue;
+                }
+
+                table[i][j] = std::min({table[i - 1][j] + 1,
+                                        table[i][j - 1] + 1,
+                                        table[i - 1][j - 1] + (lhs[i - 1] == rhs[j - 1] ? 0 : 1)});
+            }
+        }
+
+        return table[lhs.size()][rhs.size()];
+    };
+
+    std::mt19937 generator(42);
+
+    auto random_string = [&generator](size_t max_length) {
+        std::string result(generator() % (max_length + 1), 'a');
+
+        for (char& symbol : result) {
+            symbol = static_cast<char>('a' + generator() % 3);
+        }
+
+        return result;
+    };
+
+    for (size_t i = 0; i < 2000; ++i) {
+        size_t max_length = (i % 2 == 0) ? 12 : 80;
+        std::string pattern = random_string(max_length);
+        std::string text = random_string(max_length);
+        size_t max_distance = generator() % 6;
+
+        size_t expected = naive_distance(pattern, text);
+        std::optional<size_t> distance = EditDistanceMatcher(pattern).Distance(text, max_distance);
+
+        if (expected <= max_distance) {
+            ASSERT_EQ(distance, expected);
+        } else {
+            ASSERT_FALSE(distance.has_value());
+        }
+    }
+}
+
+
+TEST(ArgParserTestSuite, ObserverTest) {
+    ArgParser parser("My Parser");
+    ParseStatisticsCollector collector;
+    parser.SetObserver(&collector);
+    parser.AddIntArgument('n', "number", "Some Number");
+    parser.AddFlag('f', "flag", "Flag");
+    parser.AddIntArgument("Param1").MultiValue(1).Positional();
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 0 1 2 3 -f")));
+    parser.HelpDescription();
+
+#ifdef ARGPARSER_INSTRUMENTATION
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kTokenClassification).events, 5);
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kValueConversion).count, 5);
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kPositionalAssignment).count, 3);
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kErrorHandling).events, 1);
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kHelpRendering).events, 1);
+    ASSERT_EQ(collector.GetArgumentStatistics().at("Param1").count, 3);
+    ASSERT_NE(collector.Report().find("Param1"), std::string::npos);
+#else
+    ASSERT_TRUE(collector.GetArgumentStatistics().empty());
+    ASSERT_EQ(collector.GetPhaseStatistics(ParsePhase::kValueConversion).events, 0);
+#endif
+}
+
+
+enum class Mode {
+    kFast,
+    kSafe,
+    kDebug
+};
+
+
+TEST(ArgParserTestSuite, EnumChoicesTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<Mode>('m', "mode", "Mode")
+          .Choices({{"fast", Mode::kFast}, {"safe", Mode::kSafe}, {"debug", Mode::kDebug}})
+          .Default(Mode::kSafe);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(parser.GetValue<Mode>("mode"), Mode::kSafe);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --mode=debug")));
+    ASSERT_EQ(parser.GetValue<Mode>("mode"), Mode::kDebug);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -m fast")));
+    ASSERT_EQ(parser.GetValue<Mode>("mode"), Mode::kFast);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --mode=slow")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().candidates.size(), 3);
+    ASSERT_EQ(parser.GetError().candidates[2], "debug");
+
+    std::string help = parser.HelpDescription();
+    ASSERT_NE(help.find("--mode=<choice>"), std::string::npos);
+    ASSERT_NE(help.find("choices = fast, safe, debug; default = safe"), std::string::npos);
+}
+
+
+TEST(ArgParserTestSuite, ManyChoicesTest) {
+    std::vector<std::string> names;
+
+    for (size_t i = 0; i < 100; ++i) {
+        names.push_back("codec" + std::to_string(i));
+    }
+
+    ArgParser parser("My Parser");
+    auto& argument = parser.AddIntArgument("codec", "Codec");
+    argument.Choices({{names[0], 0}, {names[1], 1}, {names[2], 2}, {names[3], 3}, {names[4], 4},
+                      {names[5], 5}, {names[6], 6}, {names[7], 7}, {names[8], 8}, {names[9], 9},
+                      {names[42], 42}, {names[99], 99}});
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --codec=codec42")));
+    ASSERT_EQ(parser.GetIntValue("codec"), 42);
+    ASSERT_TRUE(parser.Parse(SplitString("app --codec=codec99")));
+    ASSERT_EQ(parser.GetIntValue("codec"), 99);
+    ASSERT_FALSE(parser.Parse(SplitString("app --codec=42")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --codec=codec10")));
+}
+
+
+TEST(ArgParserTestSuite, ManyFlagsTest) {
+    ArgParser parser("My Parser");
+    std::bitset<600> features;
+
+    for (size_t i = 0; i < 600; ++i) {
+        parser.AddFlag("feature" + std::to_string(i)).StoreValue(features, i);
+    }
+
+    parser.AddFlag('a', "flag-a");
+    parser.AddFlag('b', "flag-b").Default(true);
+    parser.AddFlag('c', "flag-c");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --feature0 --feature63 --feature64 --feature599 -ac")));
+    ASSERT_TRUE(parser.GetFlag("feature0"));
+    ASSERT_FALSE(parser.GetFlag("feature1"));
+    ASSERT_TRUE(parser.GetFlag("feature599"));
+    ASSERT_TRUE(parser.GetFlag("flag-a"));
+    ASSERT_TRUE(parser.GetFlag("flag-b"));
+    ASSERT_TRUE(parser.GetFlag("flag-c"));
+    ASSERT_EQ(features.count(), 4);
+    ASSERT_TRUE(features[63] && features[64]);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --feature1")));
+    ASSERT_FALSE(parser.GetFlag("feature0"));
+    ASSERT_FALSE(parser.GetFlag("flag-a"));
+    ASSERT_EQ(features.count(), 1);
+    ASSERT_TRUE(features[1]);
+}
+
+
+TEST(ArgParserTestSuite, MemoryUsageTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('n', "number", "Some Number");
+
+    size_t schema_bytes = parser.MemoryUsage().schema_bytes;
+    ASSERT_GT(schema_bytes, 0);
+
+    parser.AddIntArgument('v', "values", "A very long description of the values, which doesn't fit into a small string").MultiValue().Default(0);
+    ASSERT_GT(parser.MemoryUsage().schema_bytes, schema_bytes + sizeof(SpecificArgument<int32_t>));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 1 -v 1 -v 2 -v 3")));
+
+    ParserMemoryUsage usage = parser.MemoryUsage();
+    ASSERT_EQ(usage.arguments.size(), 2);
+    ASSERT_EQ(usage.arguments[0].argument_name, "number");
+    ASSERT_EQ(usage.arguments[0].values_bytes, 0);
+    ASSERT_EQ(usage.arguments[1].argument_name, "values");
+    ASSERT_GE(usage.arguments[1].values_bytes, 3 * sizeof(int32_t));
+    ASSERT_EQ(usage.arguments[1].values_bytes % sizeof(int32_t), 0);
+    ASSERT_GE(usage.parse_bytes, usage.arguments[1].values_bytes);
+    ASSERT_GT(usage.parse_peak_bytes, usage.parse_bytes);
+
+    // The capacity is kept for the next parse
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 1")));
+    ASSERT_EQ(parser.MemoryUsage().arguments[1].values_bytes, usage.arguments[1].values_bytes);
+    ASSERT_EQ(parser.MemoryUsage().parse_peak_bytes, parser.MemoryUsage().parse_bytes);
+}
+
+
+TEST(ArgParserTestSuite, HandleTest) {
+    ArgParser parser("My Parser");
+    ArgHandle<int32_t> number = parser.AddIntArgument('n', "number", "Some Number").Handle();
+    ArgHandle<std::string> names = parser.AddStringArgument("name", "Some names").MultiValue(1).Handle();
+    ArgHandle<bool> flag = parser.AddFlag('f', "flag", "Some flag").Handle();
+    ArgHandle<double> ratio = parser.AddDoubleArgument("ratio", "Some ratio").Default(0.5).Handle();
+    ArgHandle<int32_t> invalid;
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 10 --name=a --name b -f")));
+
+    ASSERT_EQ(parser.GetValue(number), 10);
+    ASSERT_EQ(parser.GetValue(names, 1), "b");
+    ASSERT_EQ(parser.GetValue(flag), true);
+    ASSERT_EQ(parser.GetValue(ratio), 0.5);
+    ASSERT_FALSE(invalid.IsValid());
+    ASSERT_FALSE(parser.GetValue(invalid).has_value());
+
+    std::span<const std::string> values = parser.Values(names);
+    ASSERT_EQ(values.size(), 2);
+    ASSERT_EQ(values[0], "a");
+    ASSERT_EQ(parser.Values(number).size(), 1);
+    ASSERT_TRUE(parser.Values(ratio).empty());
+
+    // The handles of another parser don't refer to the arguments with the same indices
+    ArgParser other_parser("Other Parser");
+    other_parser.AddIntArgument("other");
+    ASSERT_TRUE(other_parser.Parse(SplitString("app --other 5")));
+    ASSERT_FALSE(other_parser.GetValue(number).has_value());
+    ASSERT_TRUE(other_parser.Values(number).empty());
+
+    // Nor do the handles of a replaced argument, even of the same type
+    ArgHandle<int32_t> replaced = parser.AddIntArgument('n', "number", "Some Number").Handle();
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 20 --name=a")));
+    ASSERT_FALSE(parser.GetValue(number).has_value());
+    ASSERT_EQ(parser.GetValue(replaced), 20);
+
+    parser.AddStringArgument('n', "number", "Some Name");
+    ASSERT_TRUE(parser.Parse(SplitString("app -n ten --name=a")));
+    ASSERT_FALSE(parser.GetValue(replaced).has_value());
+    ASSERT_TRUE(parser.Values(replaced).empty());
+}
+
+
+TEST(ArgParserTestSuite, WrongValueTypeTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('n', "number", "Some Number");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 10")));
+    ASSERT_EQ(parser.GetValue<int32_t>("number"), 10);
+    ASSERT_FALSE(parser.GetValue<std::string>("number").has_value());
+    ASSERT_FALSE(parser.GetValue<int64_t>("number").has_value());
+}
+
+
+TEST(ArgParserTestSuite, GetValuesTest) {
+    ArgParser parser("My Parser");
+    std::vector<int32_t> stored_values;
+    parser.AddStringArgument('s', "str", "Some strings").MultiValue(1);
+    parser.AddIntArgument('n', "number", "Some numbers").MultiValue().StoreValues(stored_values);
+    parser.AddIntArgument("single", "Single number");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -s a -s bb --str=ccc -n 1 -n 2 --single=7")));
+
+    std::span<const std::string> strings = parser.GetValues<std::string>("str");
+    ASSERT_EQ(strings.size(), 3);
+    ASSERT_EQ(strings[2], "ccc");
+    ASSERT_EQ(parser.GetValues<int32_t>("number").size(), 2);
+    ASSERT_EQ(parser.GetValues<int32_t>("single")[0], 7);
+    ASSERT_TRUE(parser.GetValues<int32_t>("str").empty());
+    ASSERT_TRUE(parser.GetValues<int32_t>("unknown").empty());
+
+    std::vector<std::string> taken = parser.TakeValues<std::string>("str");
+    ASSERT_EQ(taken, std::vector<std::string>({"a", "bb", "ccc"}));
+    ASSERT_TRUE(parser.GetValues<std::string>("str").empty());
+
+    std::vector<int32_t> taken_numbers = parser.TakeValues<int32_t>("number");
+    ASSERT_EQ(taken_numbers, std::vector<int32_t>({1, 2}));
+    ASSERT_TRUE(stored_values.empty());
+
+    ASSERT_EQ(parser.TakeValues<int32_t>("single"), std::vector<int32_t>({7}));
+    ASSERT_FALSE(parser.GetValue<int32_t>("single").has_value());
+}
+
+
+struct CopyCounted {
+    static inline size_t copies = 0;
+
+    std::string value;
+
+    CopyCounted() = default;
+    CopyCounted(const CopyCounted& other) : value(other.value) {
+        ++copies;
+    }
+    CopyCounted(CopyCounted&& other) noexcept = default;
+    CopyCounted& operator=(const CopyCounted& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    CopyCounted& operator=(CopyCounted&& other) noexcept = default;
+};
+
+template<>
+inline std::optional<CopyCounted> ArgumentParser::ParseValue<CopyCounted>(std::string_view value_string) {
+    CopyCounted result;
+    result.value = value_string;
+    return result;
+}
+
+
+TEST(ArgParserTestSuite, ValueCopiesTest) {
+    ArgParser parser("My Parser");
+    CopyCounted stored;
+    parser.AddArgument<CopyCounted>('m', "multi").MultiValue();
+    parser.AddArgument<CopyCounted>('s', "single");
+    parser.AddArgument<CopyCounted>('t', "stored").StoreValue(stored);
+
+    CopyCounted::copies = 0;
+    ASSERT_TRUE(parser.Parse(SplitString("app -m a -m b -m c -s d -t e")));
+
+    // The stored variable is reset to the default value and then assigned the parsed one
+    ASSERT_EQ(CopyCounted::copies, 2);
+    ASSERT_EQ(stored.value, "e");
+    ASSERT_EQ(parser.GetValues<CopyCounted>("multi")[2].value, "c");
+    ASSERT_EQ(parser.GetValues<CopyCounted>("single")[0].value, "d");
+}
+
+
+struct BoundConfig {
+    int32_t threads = 4;
+    double ratio = 0.5;
+    bool verbose = false;
+    char mode = 'a';
+};
+
+
+TEST(ArgParserTestSuite, StructBindingTest) {
+    static_assert(std::is_trivially_copyable_v<BoundConfig>);
+
+    BoundConfig config;
+
+    ArgParser parser("My Parser");
+    StructBinder<BoundConfig> binder = parser.BindStruct(config);
+    binder.Bind(&BoundConfig::threads, "threads", 't', "Number of threads");
+    binder.Bind(&BoundConfig::ratio, "ratio");
+    binder.Bind(&BoundConfig::verbose, "verbose", 'v');
+    binder.Bind(&BoundConfig::mode, "mode");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -t 16 -v")));
+    ASSERT_EQ(config.threads, 16);
+    ASSERT_EQ(config.ratio, 0.5);
+    ASSERT_TRUE(config.verbose);
+    ASSERT_EQ(config.mode, 'a');
+    ASSERT_EQ(parser.GetIntValue("threads"), 16);
+    ASSERT_EQ(parser.GetValues<int32_t>("threads").data(), &config.threads);
+
+    for (const ArgumentMemoryUsage& argument : parser.MemoryUsage().arguments) {
+        ASSERT_EQ(argument.values_bytes, 0);
+    }
+
+    BoundConfig copy;
+    std::memcpy(&copy, &config, sizeof(config));
+    ASSERT_EQ(copy.threads, 16);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --ratio=2.5 --mode=z")));
+    ASSERT_EQ(config.threads, 4);
+    ASSERT_EQ(config.ratio, 2.5);
+    ASSERT_FALSE(config.verbose);
+    ASSERT_EQ(config.mode, 'z');
+}
+
+
+struct BoundListConfig {
+    std::vector<int32_t> numbers;
+    std::string name = "John";
+};
+
+
+TEST(ArgParserTestSuite, StructBindingVectorTest) {
+    BoundListConfig config;
+
+    ArgParser parser("My Parser");
+    auto binder = parser.BindStruct(config);
+    binder.Bind(&BoundListConfig::numbers, "number", 'n');
+    binder.Bind(&BoundListConfig::name, "name");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -n 1 -n 2 --name Jane")));
+    ASSERT_EQ(config.numbers, std::vector<int32_t>({1, 2}));
+    ASSERT_EQ(config.name, "Jane");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_TRUE(config.numbers.empty());
+    ASSERT_EQ(config.name, "John");
+}
+
+
+TEST(ArgParserTestSuite, ExclusiveGroupTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag('s', "sum", "Sum arguments");
+    parser.AddFlag('m', "mult", "Multiply arguments");
+    parser.AddFlag('v', "verbose", "Verbose output");
+    parser.AddExclusiveGroup({"sum", "mult"}, true);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -s")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --mult -v")));
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -v -sm")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kExclusiveArguments);
+    ASSERT_EQ(parser.GetError().argument_name, "mult");
+    ASSERT_EQ(parser.GetError().candidates.size(), 2);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -v")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kMissingGroupArgument);
+}
+
+
+TEST(ArgParserTestSuite, DependencyTest) {
+    ArgParser parser("My Parser");
+    parser.AddDependency("out", {"format", "level"});
+    parser.AddStringArgument("out", "Output file").Default("out.txt");
+    parser.AddStringArgument("format", "Output format").Default("json");
+    parser.AddIntArgument("level", "Compression level").Default(1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --format=xml")));
+    ASSERT_TRUE(parser.Parse(SplitString("app --out=a.xml --format=xml --level=5")));
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --out=a.xml --level=5")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kMissingDependency);
+    ASSERT_EQ(parser.GetError().argument_name, "out");
+    ASSERT_EQ(parser.GetError().candidates[0], "format");
+}
+
+
+TEST(ArgParserTestSuite, UnknownConstraintArgumentTest) {
+    ArgParser parser("My Parser");
+    parser.AddFlag("sum");
+    parser.AddFlag("mult");
+    parser.AddExclusiveGroup({"sum", "mutl"});
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --sum")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kUnknownConstraintArgument);
+    ASSERT_EQ(parser.GetError().argument_name, "mutl");
+
+    // The names are resolved again after the arguments change
+    parser.AddFlag("mutl");
+    ASSERT_TRUE(parser.Parse(SplitString("app --sum")));
+
+    ArgParser dependency_parser("My Parser");
+    dependency_parser.AddStringArgument("format").Default("json");
+    dependency_parser.AddDependency("otu", {"format"});
+
+    ASSERT_FALSE(dependency_parser.Parse(SplitString("app")));
+    ASSERT_EQ(dependency_parser.GetError().status, ParsingErrorType::kUnknownConstraintArgument);
+    ASSERT_EQ(dependency_parser.GetError().argument_name, "otu");
+}
+
+
+TEST(ArgParserTestSuite, ManyConstraintsTest) {
+    ArgParser parser("My Parser");
+
+    for (size_t i = 0; i < 200; ++i) {
+        parser.AddFlag("flag" + std::to_string(i));
+    }
+
+    for (size_t i = 0; i < 200; i += 2) {
+        std::string first = "flag" + std::to_string(i);
+        std::string second = "flag" + std::to_string(i + 1);
+        parser.AddExclusiveGroup({first, second});
+    }
+
+    parser.AddDependency("flag199", {"flag0", "flag100"});
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --flag0 --flag3 --flag100 --flag199")));
+    ASSERT_FALSE(parser.Parse(SplitString("app --flag198 --flag199")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kExclusiveArguments);
+    ASSERT_FALSE(parser.Parse(SplitString("app --flag199 --flag100")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kMissingDependency);
+}
+
+
+TEST(ArgParserTestSuite, RangeTest) {
+    ArgParser parser("My Parser");
+    parser.AddIntArgument('t', "threads", "Number of threads").Range(1, 256).Default(4);
+    parser.AddDoubleArgument("ratio", "Some ratio").Range(0.0, 1.0).Default(0.5);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -t 256 --ratio=0")));
+    ASSERT_EQ(parser.GetIntValue("threads"), 256);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -t 0")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kOutOfRange);
+    ASSERT_EQ(parser.GetError().argument_name, "threads");
+    ASSERT_EQ(parser.GetError().argument_string, "0");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app --ratio=1.5")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kOutOfRange);
+}
+
+
+TEST(ArgParserTestSuite, ConfigReloadTest) {
+    std::filesystem::path path = std::filesystem::temp_directory_path()
+        / ("argparser_reload_test_" + std::to_string(std::random_device{}()) + ".conf");
+    std::ofstream(path) << "# Service configuration\n--threads=8\n--name=service\n";
+
+    ConfigReloader reloader(path.string(), [](ArgParser& parser) {
+        parser.AddIntArgument("threads").Default(1);
+        parser.AddStringArgument("name");
+        parser.AddFlag("verbose");
+    });
+
+    std::shared_ptr<const ConfigSnapshot> first = reloader.GetSnapshot();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(first->GetValue<int32_t>("threads"), 8);
+    ASSERT_EQ(first->GetChangedArguments().size(), 3);
+
+    std::ofstream(path) << "--threads=16\n--name=service\n";
+    ASSERT_TRUE(reloader.Reload());
+
+    std::shared_ptr<const ConfigSnapshot> second = reloader.GetSnapshot();
+    ASSERT_EQ(second->GetVersion(), 1);
+    ASSERT_EQ(second->GetValue<int32_t>("threads"), 16);
+    ASSERT_TRUE(second->IsChanged("threads"));
+    ASSERT_FALSE(second->IsChanged("name"));
+    ASSERT_FALSE(second->IsChanged("verbose"));
+    ASSERT_EQ(second->GetChangedArguments().size(), 1);
+
+    // The old snapshot is still valid for its readers
+    ASSERT_EQ(first->GetValue<int32_t>("threads"), 8);
+
+    std::ofstream(path) << "--threads=many\n";
+    ASSERT_FALSE(reloader.Reload());
+    ASSERT_EQ(reloader.GetLastError(), ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(reloader.GetSnapshot(), second);
+
+    std::filesystem::remove(path);
+    ASSERT_FALSE(reloader.Reload());
+    ASSERT_EQ(reloader.GetLastError(), ParsingErrorType::kStreamReadError);
+    ASSERT_EQ(reloader.GetLastErrorNumber(), ENOENT);
+    ASSERT_EQ(reloader.GetSnapshot(), second);
+}
+
+
+TEST(ArgParserTestSuite, ConfigReloadCallbackTest) {
+    std::filesystem::path path = std::filesystem::temp_directory_path()
+        / ("argparser_callback_test_" + std::to_string(std::random_device{}()) + ".conf");
+    std::ofstream(path) << "--threads=8\n";
+
+    ConfigReloader reloader(path.string(), [](ArgParser& parser) {
+        parser.AddIntArgument("threads").Default(1);
+    });
+
+    // The callback may use the reloader, it's called without the reload lock
+    size_t calls = 0;
+    reloader.SetReloadCallback([&reloader, &calls](const ConfigSnapshot& snapshot) {
+        ++calls;
+        ASSERT_EQ(reloader.GetLastError(), ParsingErrorType::kSuccess);
+        ASSERT_EQ(reloader.GetSnapshot()->GetVersion(), snapshot.GetVersion());
+
+        if (snapshot.GetVersion() == 1) {
+            ASSERT_TRUE(reloader.Reload());
+            reloader.SetReloadCallback(nullptr);
+        }
+    });
+
+    std::ofstream(path) << "--threads=16\n";
+    ASSERT_TRUE(reloader.Reload());
+    ASSERT_EQ(calls, 2);
+    ASSERT_EQ(reloader.GetSnapshot()->GetVersion(), 2);
+
+    ASSERT_TRUE(reloader.Reload());
+    ASSERT_EQ(calls, 2);
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(ArgParserTestSuite, ConfigSnapshotReadersTest) {
+    std::filesystem::path path = std::filesystem::temp_directory_path()
+        / ("argparser_readers_test_" + std::to_string(std::random_device{}()) + ".conf");
+    std::ofstream(path) << "--threads=8\n";
+
+    ConfigReloader reloader(path.string(), [](ArgParser& parser) {
+        parser.AddIntArgument("threads").Default(1);
+        parser.AddDoubleArgument("ratio").Default(0.5);
+    });
+
+    std::shared_ptr<const ConfigSnapshot> snapshot = reloader.GetSnapshot();
+    ASSERT_NE(snapshot, nullptr);
+
+    // The const methods only read the published parser, see BuildCaches()
+    std::vector<std::string> helps(4);
+    std::vector<std::vector<std::string_view>> suggestions(4);
+    std::vector<std::thread> readers;
+
+    for (size_t i = 0; i < helps.size(); ++i) {
+        readers.emplace_back([&snapshot, &helps, &suggestions, i] {
+            helps[i] = snapshot->GetParser().HelpDescription();
+            suggestions[i] = snapshot->GetParser().GetSuggestions("--thread");
+        });
+    }
+
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    for (size_t i = 0; i < helps.size(); ++i) {
+        ASSERT_EQ(helps[i], helps[0]);
+        ASSERT_EQ(suggestions[i], std::vector<std::string_view>{"threads"});
+    }
+
+    ASSERT_NE(helps[0].find("[default = 0.5]"), std::string::npos);
+
+    std::filesystem::remove(path);
+}
+
+
+TEST(ArgParserTestSuite, ConfigWatchTest) {
+    std::filesystem::path path = std::filesystem::temp_directory_path()
+        / ("argparser_watch_test_" + std::to_string(std::random_device{}()) + ".conf");
+    std::ofstream(path) << "--threads=8\n";
+
+    ConfigReloader reloader(path.string(), [](ArgParser& parser) {
+        parser.AddIntArgument("threads").Default(1);
+    });
+
+    std::atomic<size_t> reloads = 0;
+    reloader.SetReloadCallback([&reloads](const ConfigSnapshot& snapshot) {
+        if (snapshot.IsChanged("threads")) {
+            ++reloads;
+        }
+    });
+
+    if (!reloader.StartWatching()) {
+        std::filesystem::remove(path);
+        GTEST_SKIP() << "inotify is not available";
+    }
+
+    std::ofstream(path) << "--threads=32\n";
+
+    for (size_t i = 0; i < 200 && reloads == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    reloader.StopWatching();
+
+    ASSERT_GT(reloads, 0);
+    ASSERT_EQ(reloader.GetSnapshot()->GetValue<int32_t>("threads"), 32);
+
+    std::filesystem::remove(path);
+}
+
+TEST(ArgParserTestSuite, DelimitedStreamReaderTest) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::string data("first\0second\0\0a-token-longer-than-a-block\0last", 46);
+    [[maybe_unused]] ssize_t written = write(fds[1], data.data(), data.size());
+    close(fds[1]);
+
+    std::vector<std::string> tokens;
+    DelimitedStreamReader reader(fds[0], '\0', 7);
+
+    ASSERT_TRUE(reader.ForEachToken([&tokens](std::string_view token) {
+        tokens.emplace_back(token);
+        return true;
+    }));
+
+    close(fds[0]);
+
+    ASSERT_EQ(tokens, (std::vector<std::string>{"first", "second", "a-token-longer-than-a-block", "last"}));
+}
+
+TEST(ArgParserTestSuite, PositionalStreamTest) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    const int32_t kCount = 100000;
+    std::thread writer([fd = fds[1]] {
+        std::string data;
+
+        for (int32_t i = 0; i < kCount; ++i) {
+            data += std::to_string(i);
+            data += '\n';
+        }
+
+        [[maybe_unused]] ssize_t written = write(fd, data.data(), data.size());
+        close(fd);
+    });
+
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number").MultiValue(1).Positional();
+    parser.ReadPositionalFrom(fds[0], '\n');
+
+    bool is_parsed = parser.Parse(SplitString("app 42"));
+    writer.join();
+    close(fds[0]);
+
+    ASSERT_TRUE(is_parsed);
+
+    std::span<const int32_t> values = parser.GetValues<int32_t>("number");
+    ASSERT_EQ(values.size(), kCount + 1);
+    ASSERT_EQ(values[0], 42);
+    ASSERT_EQ(values[kCount], kCount - 1);
+}
+
+TEST(ArgParserTestSuite, PositionalStreamErrorTest) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::string data("1\0two\0" "3", 7);
+    [[maybe_unused]] ssize_t written = write(fds[1], data.data(), data.size());
+    close(fds[1]);
+
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number").MultiValue().Positional();
+    parser.ReadPositionalFrom(fds[0]);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app")));
+    close(fds[0]);
+
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().argument_string, "two");
+}
+
+TEST(ArgParserTestSuite, PositionalStreamReadErrorTest) {
+    // Reading a directory fails with EISDIR
+    int fd = open(std::filesystem::temp_directory_path().c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number").MultiValue().Positional();
+    parser.ReadPositionalFrom(fd);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app")));
+    close(fd);
+
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kStreamReadError);
+    ASSERT_EQ(parser.GetError().error_number, EISDIR);
+    ASSERT_EQ(parser.GetError().argument_name, "number");
+}
+
+TEST(ArgParserTestSuite, PositionalStreamNoArgumentTest) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    close(fds[1]);
+
+    ArgParser parser("My Parser");
+    parser.AddIntArgument("number").Positional();
+    parser.ReadPositionalFrom(fds[0]);
+
+    ASSERT_FALSE(parser.Parse(SplitString("app 1")));
+    close(fds[0]);
+
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kNoStreamArgument);
+}
+
+TEST(ArgParserTestSuite, KeyValueMapTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<KeyValueMap>('D', "define", "Properties").Default(KeyValueMap());
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -Dmode=fast -D path=/a=b --define=mode=slow --define empty=")));
+
+    std::span<const KeyValueMap> values = parser.GetValues<KeyValueMap>("define");
+    ASSERT_EQ(values.size(), 1);
+
+    const KeyValueMap& properties = values[0];
+    ASSERT_EQ(properties.Size(), 3);
+    ASSERT_EQ(properties.Find("mode"), "slow");
+    ASSERT_EQ(properties.Find(std::string_view("path")), "/a=b");
+    ASSERT_EQ(properties.Find("empty"), "");
+    ASSERT_FALSE(properties.Contains("other"));
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -Dmode")));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+}
+
+TEST(ArgParserTestSuite, KeyValueMapDuplicatesTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<KeyValueMap>('D', "define").Default(KeyValueMap(KeyValueMap::DuplicatePolicy::kReject));
+    parser.AddArgument<KeyValueMap>('K', "keep").Default(KeyValueMap(KeyValueMap::DuplicatePolicy::kKeepFirst));
+
+    std::vector<std::string> argv = SplitString("app -Ka=1 -Ka=2 -Da=1");
+    ASSERT_TRUE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetValue<KeyValueMap>("keep")->Find("a"), "1");
+
+    ASSERT_FALSE(parser.Parse(SplitString("app -Da=1 -Da=2")));
+    ASSERT_EQ(parser.GetError().argument_name, "define");
+}
+
+TEST(ArgParserTestSuite, KeyValueMapStoreValueTest) {
+    KeyValueMap properties;
+    ArgParser parser("My Parser");
+    parser.AddArgument<KeyValueMap>('D', "define").Default(KeyValueMap()).StoreValue(properties);
+
+    std::string args = "app";
+    for (int i = 0; i < 100; ++i) {
+        args += " -Dkey" + std::to_string(i) + "=" + std::to_string(i);
+    }
+
+    ASSERT_TRUE(parser.Parse(SplitString(args)));
+    ASSERT_EQ(properties.Size(), 100);
+    ASSERT_EQ(properties.Find("key42"), "42");
+    ASSERT_EQ(parser.GetValue<KeyValueMap>("define")->Size(), 100);
+    ASSERT_EQ(parser.GetValues<KeyValueMap>("define").size(), 1);
+
+    ASSERT_TRUE(parser.Parse(SplitString("app -Da=1")));
+    ASSERT_EQ(properties.Size(), 1);
+    ASSERT_EQ(properties.Find("a"), "1");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    ASSERT_EQ(properties.Size(), 0);
+    ASSERT_EQ(parser.GetValues<KeyValueMap>("define").size(), 0);
+}
+
+TEST(ArgParserTestSuite, KeyValueMapStreamTest) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::string data = "first=1\n";
+
+    // More tokens than fit into one block of the reader, whose buffers are reused
+    for (size_t i = 0; i < 100000; ++i) {
+        data += "key" + std::to_string(i) + "=value" + std::to_string(i) + "\n";
+    }
+
+    std::thread writer([&data, fd = fds[1]] {
+        for (size_t written = 0; written < data.size();) {
+            ssize_t result = write(fd, data.data() + written, data.size() - written);
+
+            if (result <= 0) {
+                break;
+            }
+
+            written += result;
+        }
+
+        close(fd);
+    });
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<KeyValueMap>("properties").MultiValue().Positional().Default(KeyValueMap());
+    parser.ReadPositionalFrom(fds[0], '\n');
+
+    ASSERT_TRUE(parser.Parse(SplitString("app")));
+    writer.join();
+    close(fds[0]);
+
+    const KeyValueMap& properties = parser.GetValues<KeyValueMap>("properties")[0];
+    ASSERT_EQ(properties.Size(), 100001);
+    ASSERT_EQ(properties.Find("first"), "1");
+    ASSERT_EQ(properties.Find("key0"), "value0");
+    ASSERT_EQ(properties.Find("key99999"), "value99999");
+
+    // A copy owns its entries too
+    KeyValueMap copy = properties;
+    ASSERT_TRUE(parser.Parse(SplitString("app a=b")));
+    ASSERT_EQ(copy.Find("key12345"), "value12345");
+}
+
+TEST(ArgParserTestSuite, KeyValueMapGrowthTest) {
+    std::vector<std::string> keys;
+    KeyValueMap map;
+
+    for (size_t i = 0; i < 1000; ++i) {
+        keys.push_back("key" + std::to_string(i));
+    }
+
+    for (const std::string& key : keys) {
+        ASSERT_TRUE(map.Insert(key, key));
+    }
+
+    ASSERT_EQ(map.Size(), keys.size());
+
+    for (const std::string& key : keys) {
+        ASSERT_EQ(map.Find(key), key);
+    }
+
+    ASSERT_EQ(map.begin()->first, "key0");
+}
+
+std::vector<bool (*)(std::string_view)> GetUtf8Validators() {
+    std::vector<bool (*)(std::string_view)> validators = {&IsValidUtf8, &IsValidUtf8Scalar};
+
+#ifdef ARGPARSER_HAS_X86_SIMD
+    if (CpuSupportsSse4()) {
+        validators.push_back(&IsValidUtf8Sse4);
+    }
+
+    if (CpuSupportsAvx2()) {
+        validators.push_back(&IsValidUtf8Avx2);
+    }
+#endif
+
+    return validators;
+}
+
+TEST(ArgParserTestSuite, Utf8ValidationTest) {
+    std::vector<std::pair<std::string, bool>> cases = {
+        {"plain", true},
+        {"caf\xc3\xa9", true},
+        {"\xe2\x82\xac", true},
+        {"\xf0\x9f\x98\x80", true},
+        {"\xf4\x8f\xbf\xbf", true},
+        {"\xc3", false},
+        {"\xe2\x82", false},
+        {"\xf0\x9f\x98", false},
+        {"\x80", false},
+        {"\xc0\xaf", false},
+        {"\xe0\x80\xaf", false},
+        {"\xf0\x80\x80\xaf", false},
+        {"\xed\xa0\x80", false},
+        {"\xf4\x90\x80\x80", false},
+        {"\xf8\x88\x80\x80\x80", false},
+        {"\xff", false},
+        {"\xc3\xa9\xa9", false},
+        {"\xe2\x28\xa1", false},
+    };
+
+    for (auto validate : GetUtf8Validators()) {
+        for (const auto& [text, is_valid] : cases) {
+            // Every offset in a block and across the block borders
+            for (size_t offset = 0; offset < 70; offset += 3) {
+                std::string padded = std::string(offset, 'a') + text + std::string(offset % 7, 'b');
+                ASSERT_EQ(validate(padded), is_valid) << offset << ' ' << text;
+            }
+        }
+    }
+}
+
+TEST(ArgParserTestSuite, Utf8FuzzTest) {
+    std::mt19937 random(42);
+    const std::vector<std::string> pieces = {"a", "z0", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\x9f\xbf",
+                                             "\x80", "\xc3", "\xe2\x82", "\xf0\x9f", "\xf5", "\xed\xa0\x80", "\xe0\x9f\xbf"};
+
+    for (size_t iteration = 0; iteration < 20000; ++iteration) {
+        std::string text;
+        size_t count = random() % 40;
+
+        for (size_t i = 0; i < count; ++i) {
+            // The invalid pieces are rare, so that many texts are valid
+            size_t piece = random() % (random() % 8 == 0 ? pieces.size() : 6);
+            text += pieces[piece];
+        }
+
+        bool expected = IsValidUtf8Scalar(text);
+
+        for (auto validate : GetUtf8Validators()) {
+            ASSERT_EQ(validate(text), expected) << iteration;
+        }
+    }
+}
+
+TEST(ArgParserTestSuite, ValidateUtf8ArgumentTest) {
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("label").ValidateUtf8();
+    parser.AddStringArgument("raw").Default("");
+
+    ASSERT_TRUE(parser.Parse(std::vector<std::string>{"app", "--label=caf\xc3\xa9", "--raw=\xff"}));
+    ASSERT_EQ(parser.GetStringValue("label"), "caf\xc3\xa9");
+
+    ASSERT_FALSE(parser.Parse(std::vector<std::string>{"app", "--label=caf\xc3", "--raw=x"}));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().argument_string, "--label=caf\xc3");
+    ASSERT_EQ(parser.GetError().argument_name, "label");
+}
+
+TEST(ArgParserTestSuite, ValidateUtf8ParserTest) {
+    ArgParser parser("My Parser");
+    parser.AddStringArgument("label");
+    parser.AddStringArgument("path").Default("");
+    parser.ValidateUtf8();
+
+    // The tokens are stored in one area like the argv given to main
+    std::string area("app\0--label=\xd0\xbc\xd0\xb8\xd1\x80\0--path=/tmp/\xe2\x82\xac", 34);
+    std::vector<std::string_view> argv = {std::string_view(area.data(), 3),
+                                          std::string_view(area.data() + 4, 14),
+                                          std::string_view(area.data() + 19, 15)};
+
+    ASSERT_TRUE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetStringValue("path"), "/tmp/\xe2\x82\xac");
+
+    area[33] = '\xff';
+
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().argument_string, argv[2]);
+
+    ASSERT_FALSE(parser.Parse(std::vector<std::string>{"app", "--label=\xc0\xaf"}));
+    ASSERT_EQ(parser.GetError().argument_string, "--label=\xc0\xaf");
+}
+
+
+std::filesystem::path MakeTestDirectory(const std::string& name) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path()
+        / ("argparser_" + name + "_" + std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(directory);
+
+    return directory;
+}
+
+
+TEST(ArgParserTestSuite, PathCheckBatchTest) {
+    std::filesystem::path directory = MakeTestDirectory("path_batch_test");
+    std::filesystem::path file = directory / "input.txt";
+    std::filesystem::path missing = directory / "missing.txt";
+    std::ofstream(file) << "12345";
+
+    PathCheckBatch batch;
+    batch.Add(file);
+    batch.Add(directory);
+    batch.Add(missing);
+    batch.Add(file / "child");
+    batch.RunThreadPool();
+
+    ASSERT_TRUE(batch.GetResult(0).IsRegularFile());
+    ASSERT_EQ(batch.GetResult(0).size, 5);
+    ASSERT_TRUE(batch.GetResult(1).IsDirectory());
+    ASSERT_FALSE(batch.GetResult(2).Exists());
+    ASSERT_EQ(batch.GetResult(2).error, ENOENT);
+    ASSERT_EQ(batch.GetResult(3).type, std::filesystem::file_type::not_found);
+
+    UserCredentials credentials = UserCredentials::GetCurrent();
+    PathRequirements requirements;
+    requirements.is_regular_file = true;
+    requirements.is_readable = true;
+    ASSERT_TRUE(requirements.IsSatisfied(batch.GetResult(0), credentials));
+    ASSERT_FALSE(requirements.IsSatisfied(batch.GetResult(1), credentials));
+    ASSERT_FALSE(requirements.IsSatisfied(batch.GetResult(2), credentials));
+
+    // A file without any execute bit isn't executable even by root
+    std::filesystem::permissions(file, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+    batch.Clear();
+    batch.Add(file);
+    batch.Run();
+    ASSERT_FALSE(HasAccess(batch.GetResult(0), PathAccess::kExecute, credentials));
+    ASSERT_EQ(batch.GetResult(0).permissions, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+    std::filesystem::remove_all(directory);
+}
+
+
+TEST(ArgParserTestSuite, PathAccessCredentialsTest) {
+    PathMetadata metadata;
+    metadata.type = std::filesystem::file_type::regular;
+    metadata.permissions = static_cast<std::filesystem::perms>(0640);
+    metadata.owner = 1000;
+    metadata.group = 100;
+
+    UserCredentials owner{1000, 1000, {}};
+    UserCredentials member{1001, 1001, {27, 100}};
+    UserCredentials other{1002, 1002, {27}};
+    UserCredentials root{0, 0, {}};
+
+    ASSERT_TRUE(HasAccess(metadata, PathAccess::kWrite, owner));
+    ASSERT_TRUE(HasAccess(metadata, PathAccess::kRead, member));
+    ASSERT_FALSE(HasAccess(metadata, PathAccess::kWrite, member));
+    ASSERT_FALSE(HasAccess(metadata, PathAccess::kRead, other));
+    ASSERT_TRUE(HasAccess(metadata, PathAccess::kWrite, root));
+    ASSERT_FALSE(HasAccess(metadata, PathAccess::kExecute, root));
+}
+
+
+TEST(ArgParserTestSuite, PathCheckIoUringTest) {
+    if (!PathCheckBatch::IsIoUringAvailable()) {
+        GTEST_SKIP() << "io_uring is unavailable";
+    }
+
+    std::filesystem::path directory = MakeTestDirectory("path_io_uring_test");
+    std::vector<std::filesystem::path> paths;
+
+    // More paths than the entries of the ring, so they are submitted in several rounds
+    for (size_t i = 0; i < 600; ++i) {
+        paths.push_back(directory / ("file" + std::to_string(i)));
+
+        if (i % 3 != 0) {
+            std::ofstream(paths.back()) << std::string(i, 'x');
+        }
+    }
+
+    PathCheckBatch io_uring_batch;
+    PathCheckBatch thread_pool_batch;
+
+    for (const std::filesystem::path& path : paths) {
+        io_uring_batch.Add(path);
+        thread_pool_batch.Add(path);
+    }
+
+    ASSERT_TRUE(io_uring_batch.RunIoUring());
+    thread_pool_batch.RunThreadPool();
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        ASSERT_EQ(io_uring_batch.GetResult(i), thread_pool_batch.GetResult(i)) << paths[i];
+        ASSERT_EQ(io_uring_batch.GetResult(i).Exists(), i % 3 != 0);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+
+TEST(ArgParserTestSuite, PathArgumentTest) {
+    std::filesystem::path directory = MakeTestDirectory("path_argument_test");
+    std::vector<std::string> files;
+
+    for (size_t i = 0; i < 20; ++i) {
+        files.push_back((directory / ("input" + std::to_string(i))).string());
+        std::ofstream(files.back()) << std::string(i, 'x');
+    }
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<std::filesystem::path>("input").MultiValue(1).Positional().MustExist().IsRegularFile().Readable();
+    parser.AddArgument<std::filesystem::path>('o', "output").IsDirectory().Writable();
+    parser.AddArgument<std::filesystem::path>("log").Default("missing.log").MustExist();
+
+    std::vector<std::string> argv = {"app", "-o", directory.string()};
+    argv.insert(argv.end(), files.begin(), files.end());
+
+    ASSERT_TRUE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetValues<std::filesystem::path>("input").size(), files.size());
+
+    std::span<const PathMetadata> metadata = parser.GetPathMetadata("input");
+    ASSERT_EQ(metadata.size(), files.size());
+    ASSERT_EQ(metadata[7].size, 7);
+    ASSERT_TRUE(parser.GetPathMetadata("output")[0].IsDirectory());
+    ASSERT_TRUE(parser.GetPathMetadata("log").empty());
+
+    std::string missing = (directory / "missing").string();
+    argv.push_back(missing);
+
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidPath);
+    ASSERT_EQ(parser.GetError().argument_string, missing);
+    ASSERT_EQ(parser.GetError().argument_name, "input");
+
+    ASSERT_FALSE(parser.Parse(std::vector<std::string>{"app", "-o", files[0], files[0]}));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidPath);
+    ASSERT_EQ(parser.GetError().argument_name, "output");
+
+    std::filesystem::remove_all(directory);
+}
+
+
+TEST(ArgParserTestSuite, GlobMatchTest) {
+    ASSERT_TRUE(MatchGlobSegment("*.parquet", "part-0001.parquet"));
+    ASSERT_FALSE(MatchGlobSegment("*.parquet", "part-0001.parquet.tmp"));
+    ASSERT_TRUE(MatchGlobSegment("part-????.*", "part-0001.csv"));
+    ASSERT_TRUE(MatchGlobSegment("[a-c]*[!0-9]", "beta"));
+    ASSERT_FALSE(MatchGlobSegment("[a-c]*[!0-9]", "beta7"));
+    ASSERT_TRUE(MatchGlobSegment("[]]x", "]x"));
+    ASSERT_TRUE(MatchGlobSegment("a\\*b", "a*b"));
+    ASSERT_FALSE(MatchGlobSegment("a\\*b", "axb"));
+    ASSERT_TRUE(MatchGlobSegment("*a*b*c", "xaybzzbc"));
+    ASSERT_TRUE(MatchGlobSegment("[x", "[x"));
+
+    // A leading dot is matched only explicitly
+    ASSERT_FALSE(MatchGlobSegment("*", ".hidden"));
+    ASSERT_TRUE(MatchGlobSegment(".*", ".hidden"));
+
+    ASSERT_TRUE(IsGlobPattern("data/**/*.parquet"));
+    ASSERT_FALSE(IsGlobPattern("data/file\\*.txt"));
+}
+
+
+TEST(ArgParserTestSuite, GlobArgumentTest) {
+    std::filesystem::path directory = MakeTestDirectory("glob_argument_test");
+
+    for (const char* file : {"a/x.parquet", "a/b/y.parquet", "c/z.parquet", ".hidden/w.parquet",
+                             "top.parquet", "readme.txt"}) {
+        std::filesystem::create_directories((directory / file).parent_path());
+        std::ofstream(directory / file) << file;
+    }
+
+    std::string root = directory.string();
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<std::filesystem::path>("input").MultiValue(1).Positional().Glob().MustExist();
+
+    ASSERT_TRUE(parser.Parse(std::vector<std::string>{"app", root + "/**/*.parquet", root + "/readme.txt"}));
+
+    std::span<const std::filesystem::path> inputs = parser.GetValues<std::filesystem::path>("input");
+    std::vector<std::filesystem::path> expected = {directory / "a/b/y.parquet", directory / "a/x.parquet",
+                                                   directory / "c/z.parquet", directory / "top.parquet",
+                                                   directory / "readme.txt"};
+    ASSERT_EQ(std::vector<std::filesystem::path>(inputs.begin(), inputs.end()), expected);
+
+    ASSERT_TRUE(parser.Parse(std::vector<std::string>{"app", root + "/[ab]/?.parquet"}));
+    ASSERT_EQ(parser.GetValues<std::filesystem::path>("input").size(), 1);
+    ASSERT_EQ(parser.GetValue<std::filesystem::path>("input"), directory / "a/x.parquet");
+
+    ASSERT_TRUE(parser.Parse(std::vector<std::string>{"app", root + "/*/b/*"}));
+    ASSERT_EQ(parser.GetValue<std::filesystem::path>("input"), directory / "a/b/y.parquet");
+
+    std::vector<std::string> argv = {"app", root + "/**/*.csv"};
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kNoGlobMatch);
+    ASSERT_EQ(parser.GetError().argument_string, argv[1]);
+
+    std::vector<std::string> names;
+    ArgParser string_parser("My Parser");
+    string_parser.AddStringArgument("input").MultiValue().Positional().Glob().StoreValues(names);
+
+    ASSERT_TRUE(string_parser.Parse(std::vector<std::string>{"app", root + "/**"}));
+    ASSERT_EQ(names.size(), 8);
+    ASSERT_TRUE(std::is_sorted(names.begin(), names.end()));
+
+    // A single value argument takes a pattern with one match only
+    ArgParser single_parser("My Parser");
+    single_parser.AddStringArgument("in").Positional().Glob();
+
+    ASSERT_TRUE(single_parser.Parse(std::vector<std::string>{"app", root + "/c/*.parquet"}));
+    ASSERT_EQ(single_parser.GetStringValue("in"), root + "/c/z.parquet");
+
+    argv = {"app", root + "/*/*.parquet"};
+    ASSERT_FALSE(single_parser.Parse(argv));
+    ASSERT_EQ(single_parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(single_parser.GetError().argument_string, argv[1]);
+
+    std::filesystem::remove_all(directory);
+}
+
+
+TEST(ArgParserTestSuite, GlobParallelWalkTest) {
+    std::filesystem::path directory = MakeTestDirectory("glob_parallel_test");
+    size_t files_count = 0;
+
+    for (size_t i = 0; i < 40; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            std::filesystem::path subdirectory = directory / ("d" + std::to_string(i)) / ("e" + std::to_string(j));
+            std::filesystem::create_directories(subdirectory);
+
+            for (size_t k = 0; k < 10; ++k) {
+                std::ofstream(subdirectory / ("f" + std::to_string(k) + (k % 2 == 0 ? ".dat" : ".log")));
+                files_count += k % 2 == 0;
+            }
+        }
+    }
+
+    std::string pattern = directory.string() + "/**/*.dat";
+
+    std::vector<std::string> serial = GlobExpander(1).Expand(pattern);
+    ASSERT_EQ(serial.size(), files_count);
+    ASSERT_TRUE(std::is_sorted(serial.begin(), serial.end()));
+
+    GlobExpander expander(8);
+
+    for (size_t i = 0; i < 5; ++i) {
+        ASSERT_EQ(expander.Expand(pattern), serial);
+    }
+
+    ASSERT_EQ(expander.Expand(directory.string() + "/d1*/e[0-2]/f?.log").size(), 11 * 3 * 5);
+
+    std::filesystem::remove_all(directory);
+}
+
+
+struct Point3 {
+    double x = 0;
+    double y = 0;
+    double z = 0;
+
+    bool operator==(const Point3& other) const = default;
+};
+
+using BoundingBox = std::array<double, 4>;
+using IntRange = std::array<int32_t, 2>;
+using IntPoint = std::array<int32_t, 3>;
+
+template<>
+struct ArgumentParser::TupleTraits<Point3> {
+    using ElementType = double;
+    static constexpr size_t kArity = 3;
+
+    static double& Get(Point3& point, size_t index) {
+        return index == 0 ? point.x : (index == 1 ? point.y : point.z);
+    }
+};
+
+
+TEST(ArgParserTestSuite, TupleArgumentTest) {
+    ArgParser parser("My Parser");
+    parser.AddArgument<BoundingBox>("bbox", "Bounding box").MultiValue().Default(BoundingBox{});
+    parser.AddArgument<IntRange>('r', "range").Default({0, 100});
+    parser.AddArgument<Point3>("point");
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --bbox 0 0 10 -5.5 --point 1 2 3 --bbox=1 2 3 4 -r -5 5")));
+
+    std::span<const BoundingBox> boxes = parser.GetValues<BoundingBox>("bbox");
+    ASSERT_EQ(boxes.size(), 2);
+    ASSERT_EQ(boxes[0], (BoundingBox{0, 0, 10, -5.5}));
+    ASSERT_EQ(boxes[1], (BoundingBox{1, 2, 3, 4}));
+    ASSERT_EQ(parser.GetValue<IntRange>("range"), (IntRange{-5, 5}));
+    ASSERT_EQ(parser.GetValue<Point3>("point"), (Point3{1, 2, 3}));
+
+    ASSERT_TRUE(parser.Parse(SplitString("app --point 0 0 0 -r5 7")));
+    ASSERT_EQ(parser.GetValue<IntRange>("range"), (IntRange{5, 7}));
+    ASSERT_TRUE(parser.GetValues<BoundingBox>("bbox").empty());
+
+    std::vector<std::string> argv = SplitString("app --point 1 2 --bbox 1 2 3");
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+    ASSERT_EQ(parser.GetError().argument_string, "--bbox");
+
+    argv = SplitString("app --point 1 2 3 --bbox 1 2 3");
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInsufficent);
+    ASSERT_EQ(parser.GetError().argument_name, "bbox");
+
+    std::string help = parser.HelpDescription();
+    ASSERT_NE(help.find("--bbox <double> <double> <double> <double>"), std::string::npos);
+    ASSERT_NE(help.find("-r, --range <int> <int>"), std::string::npos);
+    ASSERT_EQ(parser.GetValue<IntRange>("range"), (IntRange{0, 100}));
+}
+
+
+TEST(ArgParserTestSuite, TupleStorageTest) {
+    constexpr size_t kTuplesCount = 10000;
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<IntPoint>('p', "point").MultiValue(1);
+
+    std::vector<std::string> argv = {"app"};
+
+    for (size_t i = 0; i < kTuplesCount; ++i) {
+        argv.insert(argv.end(), {"-p", std::to_string(i), std::to_string(i + 1), std::to_string(i + 2)});
+    }
+
+    ASSERT_TRUE(parser.Parse(argv));
+
+    std::span<const IntPoint> points = parser.GetValues<IntPoint>("point");
+    ASSERT_EQ(points.size(), kTuplesCount);
+
+    // The tuples form one flat buffer of elements
+    const int32_t* elements = points[0].data();
+
+    for (size_t i = 0; i < kTuplesCount * 3; ++i) {
+        ASSERT_EQ(elements[i], static_cast<int32_t>(i / 3 + i % 3));
+    }
+}
+
+
+ARGPARSER_DECLARE_OPTION(int32_t, threads);
+ARGPARSER_DECLARE_OPTION(std::string, log_level);
+ARGPARSER_DEFINE_OPTION(bool, dry_run, false, "Print the actions instead of doing them");
+
+TEST(ArgParserTestSuite, DefinedOptionsTest) {
+    ASSERT_EQ(*option_threads, 4);
+    ASSERT_FALSE(*option_dry_run);
+
+    // Only the parsers which ask for the defined options get them
+    ArgParser other_parser("Other Parser");
+    std::vector<std::string> argv = SplitString("app --threads 8");
+    ASSERT_FALSE(other_parser.Parse(argv));
+
+    ArgParser parser("My Parser");
+    parser.AddArgument<int32_t>("depth").Default(1);
+    parser.UseDefinedOptions();
+
+    argv = SplitString("app --threads 8 --log_level debug --dry_run --depth 2");
+    ASSERT_TRUE(parser.Parse(argv));
+    ASSERT_EQ(*option_threads, 8);
+    ASSERT_EQ(*option_log_level, "debug");
+    ASSERT_TRUE(*option_dry_run);
+    ASSERT_EQ(parser.GetValue<int32_t>("depth"), 2);
+    ASSERT_EQ(parser.GetValue<int32_t>("threads"), 8);
+
+    argv = SplitString("app");
+    ASSERT_TRUE(parser.Parse(argv));
+    ASSERT_EQ(*option_threads, 4);
+    ASSERT_EQ(*option_log_level, "info");
+    ASSERT_FALSE(*option_dry_run);
+
+    argv = SplitString("app --threads many");
+    ASSERT_FALSE(parser.Parse(argv));
+    ASSERT_EQ(parser.GetError().status, ParsingErrorType::kInvalidArgument);
+
+    std::string help = parser.HelpDescription();
+    size_t dry_run = help.find("--dry_run");
+    size_t log_level = help.find("--log_level=<string>");
+    size_t threads = help.find("--threads=<int>");
+
+    ASSERT_NE(threads, std::string::npos);
+    ASSERT_LT(dry_run, log_level);
+    ASSERT_LT(log_level, threads);
+    ASSERT_NE(help.find("Number of worker threads"), std::string::npos);
+}
@@ -0,0 +1,8 @@
+#include "lib/DefinedOption.hpp"
+
+#include <cstdint>
+#include <string>
+
+// The options of the test defined in another translation unit
+ARGPARSER_DEFINE_OPTION(int32_t, threads, 4, "Number of worker threads");
+ARGPARSER_DEFINE_OPTION(std::string, log_level, "info", "Minimal level of the logged messages");